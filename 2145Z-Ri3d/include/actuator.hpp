@@ -0,0 +1,71 @@
+#pragma once
+
+#include "subsystems.hpp"
+
+// ** @file actuator.hpp
+// ** @brief This file contains the typed motor commands and the actuators that write them.
+// ** @details Subsystems say what they want with millivolts, rpm or percent and the actuator writes it to the motor
+// once per tick. The command types can't be mixed up with each other or with a bare number, the same way okapi's
+// units can't, so a voltage can't end up in move_velocity() again.
+// ** @author Ansh Rao - 2145Z
+
+// Defining actuator constants
+#define ACTUATOR_MAX_MV 12000
+
+// declaring actuator command types
+// - the constructors are explicit so the type has to be written out where the command is made
+struct millivolts {
+    int value;
+    constexpr explicit millivolts(int value) : value(value) {}
+};
+struct rpm {
+    double value;
+    constexpr explicit rpm(double value) : value(value) {}
+};
+struct percent {
+    double value;  // of the motor's top speed, so it runs as a velocity
+    constexpr explicit percent(double value) : value(value) {}
+};
+
+// declaring actuator mode enum
+enum actuator_mode {
+    ACTUATOR_VOLTAGE = 0,
+    ACTUATOR_VELOCITY,
+    ACTUATOR_PERCENT,
+};
+
+// declaring actuator command struct
+// - any of the command types turns into one of these, a bare number doesn't
+struct actuator_command {
+    actuator_mode mode = ACTUATOR_VOLTAGE;
+    double value = 0.0;  // mV, rpm or percent
+
+    constexpr actuator_command() = default;
+    constexpr actuator_command(millivolts command) : mode(ACTUATOR_VOLTAGE), value(command.value) {}
+    constexpr actuator_command(rpm command) : mode(ACTUATOR_VELOCITY), value(command.value) {}
+    constexpr actuator_command(percent command) : mode(ACTUATOR_PERCENT), value(command.value) {}
+
+    // @brief Which way the command turns the motor, 1 forwards, -1 backwards and 0 stopped
+    constexpr int direction() const { return (value > 0.0) - (value < 0.0); }
+};
+
+// declaring actuator struct
+struct actuator {
+    pros::Motor& motor;
+    actuator_command pending;  // what the subsystem set this tick
+    actuator_mode written_mode = ACTUATOR_VOLTAGE;
+    double written = 0.0;      // mV or rpm last sent to the motor
+
+    actuator(pros::Motor& motor) : motor(motor) {}
+};
+
+// declaring actuators
+// - the rollers are sent voltages by the roller group in roller_group.hpp, which closes velocity on both together
+inline actuator actuator_intake(motor_intake);
+inline actuator actuator_roller1(motor_roller1);
+inline actuator actuator_roller2(motor_roller2);
+
+// declaring actuator functions
+void actuator_set(actuator& act, actuator_command command);
+void actuator_write(actuator& act);
+double actuator_max_rpm(const actuator& act);
@@ -1,8 +1,10 @@
 #pragma once
 
 void default_constants();
+void paths_init();
 
 void drive_example();
+void drive_no_imu();
 void turn_example();
 void drive_and_turn();
 void wait_until_change_speed();
@@ -15,4 +17,7 @@ void odom_pure_pursuit_example();
 void odom_pure_pursuit_wait_until_example();
 void odom_boomerang_example();
 void odom_boomerang_injected_pure_pursuit_example();
-void measure_offsets();
\ No newline at end of file
+void odom_trajectory_example();
+void profile_drive_example();
+void measure_offsets();
+void measure_feedforward();
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+
+#include "EZ-Template/api.hpp"
+#include "battery_comp.hpp"
+
+// ** @file battery.hpp
+// ** @brief This file contains the function headers for compensating outputs for the battery voltage.
+// ** @details battery_iterate() filters pros::battery readings in the executive. Our own outputs, the actuators
+// and the trajectory follower, multiply by battery_scale_get(). EZ-Template's PID can't be changed, so instead its
+// gains and the current motion's max speed are scaled, which scales its output the same way.
+// ** @author Ansh Rao - 2145Z
+
+// Defining battery constants
+#define BATTERY_RATE 50            // Hz the battery is read at
+#define BATTERY_APPLY_STEP 0.005   // how much the scale has to move before EZ-Template's gains are set again
+
+// declaring battery gains struct
+// - the PID gains default_constants() set, before they're scaled
+struct battery_gains {
+    PID::Constants drive_forward;
+    PID::Constants drive_backward;
+    PID::Constants heading;
+    PID::Constants turn;
+    PID::Constants swing_forward;
+    PID::Constants swing_backward;
+};
+
+// declaring battery motion struct
+// - what EZ-Template's setters change when a motion starts, so a new one can be told apart from the last
+struct battery_motion {
+    ez::e_mode mode = ez::DISABLE;
+    double left = 0.0;
+    double right = 0.0;
+    double turn = 0.0;
+    double swing = 0.0;
+
+    bool operator==(const battery_motion&) const = default;
+};
+
+// declaring battery variables
+// - only the executive touches these, apart from reading the scale
+inline battery_comp battery_state;
+inline bool battery_comp_enabled = true;  // Set false to run everything off whatever the battery gives
+inline battery_gains battery_base;
+inline double battery_applied = 1.0;      // the scale EZ-Template's gains were last set with
+inline battery_motion battery_motion_last;
+inline std::atomic<bool> battery_motion_pending = false;  // set by battery_motion_start()
+inline std::atomic<int> battery_speed_requested = 0;      // the max speed the current motion asked for
+
+// declaring battery functions
+void battery_start();
+void battery_iterate();
+double battery_scale_get();
+void battery_motion_start();
+void battery_speed_max_set(int speed);
+void battery_print();
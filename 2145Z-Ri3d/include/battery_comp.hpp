@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+// ** @file battery_comp.hpp
+// ** @brief This file contains the battery voltage filter and the scale that makes outputs act like a fixed voltage.
+// ** @details Readings are low-pass filtered, so one hard acceleration doesn't move the scale. Voltages are mV.
+// ** @author Ansh Rao - 2145Z
+//
+// Motor outputs are fractions of whatever the battery gives, so the same auton is slower on a 12.2V battery than on
+// a 13V one. Scaling every output by nominal / battery makes them all act like the battery is at nominal. Nominal
+// is below what a battery sits at under load, so there's headroom to scale up into. A full battery gets scaled down
+// instead, which is what makes the autons the same every time.
+
+// Defining battery compensation constants
+#define BATTERY_NOMINAL 12000.0  // mV outputs are scaled to act like
+#define BATTERY_TAU 0.5          // s, the filter's time constant, slower than a sag from one hard acceleration
+#define BATTERY_MIN_SCALE 0.85   // the most a full battery gets scaled down
+#define BATTERY_MAX_SCALE 1.20   // the most a flat battery gets scaled up, past this there's no headroom anyway
+
+// declaring battery compensation struct
+struct battery_comp {
+    double filtered = BATTERY_NOMINAL;  // mV
+    bool primed = false;                // false until the first reading, which is taken as is
+};
+
+// @brief Adds a battery reading to the filter
+// @param battery The filter
+// @param voltage The battery voltage in mV
+// @param dt Seconds since the last reading
+inline void battery_filter(battery_comp& battery, double voltage, double dt) {
+    if (!battery.primed) {
+        battery.filtered = voltage;
+        battery.primed = true;
+        return;
+    }
+    battery.filtered += (voltage - battery.filtered) * std::min(1.0, dt / BATTERY_TAU);
+}
+
+// @brief Gets what outputs should be multiplied by to act like the battery is at BATTERY_NOMINAL
+inline double battery_scale(const battery_comp& battery) {
+    if (battery.filtered <= 0.0) {return 1.0;}
+    return std::clamp(BATTERY_NOMINAL / battery.filtered, BATTERY_MIN_SCALE, BATTERY_MAX_SCALE);
+}
+
+// @brief Scales an output and keeps it within its limit
+// @param output The output, in whatever units the motor takes
+// @param limit The largest output the motor takes, 127 for drive_set and 12000 for move_voltage
+inline double battery_apply(double scale, double output, double limit) {
+    return std::clamp(output * scale, -limit, limit);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "rls.hpp"
+#include "subsystems.hpp"
+
+// ** @file calibration.hpp
+// ** @brief This file contains the function headers for calibrating the tracking wheel offsets and IMU scaler online.
+// ** @details The odom task feeds every turn the robot makes into least squares estimators, so the offsets keep up
+// with rebuilds without running measure_offsets(). Estimates are saved to the SD card when the robot is disabled
+// and loaded back on startup.
+// ** @author Ansh Rao - 2145Z
+//
+// The parallel tracker reads the center's forward travel plus its offset times the angle turned, and the drive
+// encoders give the center's forward travel, so (tracker - drive encoders) / angle is the offset. A tank drive
+// doesn't move sideways, so the perpendicular tracker / angle is its offset. Both are measured against the IMU, so
+// the IMU scaler can only be calibrated against something that knows the real heading, the GPS.
+
+// Defining calibration constants
+#define CALIB_FILE "/usd/calib.txt"
+#define CALIB_WINDOW 10          // odom updates summed into one sample, 50ms
+#define CALIB_MIN_TURN 3.0       // degrees a window has to turn to say anything about the offsets
+#define CALIB_MIN_GPS_TURN 45.0  // degrees the robot has to turn between GPS fixes to say anything about the IMU
+#define CALIB_MIN_SAMPLES 50     // samples an estimate needs before it's used or saved
+#define CALIB_GATE 0.5           // inches a window can miss the offset estimate by before it's called wheel slip
+#define CALIB_GPS_GATE 10.0      // degrees a turn can miss the IMU scaler estimate by before it's thrown out
+
+// declaring calibration window struct
+struct calib_window {
+    double vert = 0.0;   // parallel tracker, inches
+    double horiz = 0.0;  // perpendicular tracker, inches
+    double ime = 0.0;    // drive encoders, inches
+    double theta = 0.0;  // IMU, degrees
+    int count = 0;
+};
+
+// declaring calibration variables
+// - the estimators are only updated by the odom task
+inline rls1 calib_vert(OFFSET_VERT, 100.0, 0.9995);
+inline rls1 calib_horiz(OFFSET_HORI, 100.0, 0.9995);
+inline rls1 calib_imu(1.0, 1.0, 0.999);
+inline calib_window calib_current;
+inline bool calib_enabled = true;
+inline bool calib_gps_anchored = false;
+
+// declaring calibration functions
+void calib_load();
+void calib_save();
+void calib_print();
+double calib_vert_offset();
+double calib_horiz_offset();
+void calib_restart();
+void calib_sample(double d_vert, double d_horiz, double d_ime, double d_theta);
+void calib_gps_sample(double gps_heading, double imu_rotation);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "ff_fit.hpp"
+
+// ** @file characterize.hpp
+// ** @brief This file contains the function headers for measuring the drive's feedforward constants.
+// ** @details measure_feedforward() in autons.cpp runs ramp and step tests, fits kS, kV and kA for each side and for
+// turning with ff_fit.hpp, and saves them to the SD card. default_constants() loads them back into traj_k every time
+// the program starts, which is where the trajectory follower and the profiled drive get them from.
+// ** @author Ansh Rao - 2145Z
+//
+// Linear constants are in drive_set output per in/s and in/s^2 of wheel travel. Angular constants are drive_set
+// output per deg/s and deg/s^2 of IMU heading, measured as (left - right) / 2. Outputs are recorded at
+// BATTERY_NOMINAL, the same as the followers apply them.
+
+// Defining characterisation constants
+// - the straight tests go up to ~27" forward, leave two tiles clear in front of the robot
+#define FF_FILE "/usd/ff.txt"
+#define FF_RAMP_RATE 24.0    // drive_set output per second the slow tests ramp by
+#define FF_RAMP_TIME 2.5     // s
+#define FF_STEP_OUTPUT 70.0  // drive_set output of the step tests, kept under the motors' current limit
+#define FF_STEP_TIME 0.5     // s
+#define FF_REST 750          // ms to let the robot stop between tests
+#define FF_SPAN 3            // samples either side of the central differences, 30ms
+#define FF_MIN_R2 0.9        // fits that explain less than this are thrown out
+
+// declaring characterisation functions
+void ff_test(ff_fit& left, ff_fit& right, ff_fit& angular, bool turn, double start, double rate, double time);
+bool ff_load();
+void ff_save();
+void ff_print();
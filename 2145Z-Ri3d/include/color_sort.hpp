@@ -0,0 +1,25 @@
+#pragma once
+
+#include "sort_pipeline.hpp"
+
+// ** @file color_sort.hpp
+// ** @brief This file contains the function headers for the colour sort.
+// ** @details The optical sensor watches blocks going into the rollers. Blocks of the other alliance's colour are
+// thrown out the top by reversing the second roller when roller1's encoder says the block has reached it.
+// ** @author Ansh Rao - 2145Z
+
+// Defining colour sort constants
+#define SORT_RATE 200               // Hz, as fast as the executive goes
+#define SORT_INTEGRATION_TIME 3     // ms, the fastest the optical sensor can update
+#define SORT_LED 100                // optical sensor LED brightness, percent
+#define SORT_EJECT_VOLTAGE -12000   // roller2 voltage while ejecting
+
+// declaring colour sort variables
+inline sort_pipeline sorter;
+inline bool sort_enabled = true;
+
+// declaring colour sort functions
+void sort_init();
+void sort_iterate();
+bool sort_ejecting();
+void sort_print();
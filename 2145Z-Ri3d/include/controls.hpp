@@ -1,5 +1,9 @@
 #pragma once
 
+#include "actuator.hpp"
+#include "intake_jam.hpp"
+#include "roller_group.hpp"
+
 // ** @file controls.hpp
 // ** @brief This file contains the function headers for the robot's controls.
 // ** @details This includes the driver and autonomous controls, as well as the tasks connecting both
@@ -13,20 +17,30 @@ inline bool isPto = false;
 // declaring global functions
 void default_constants();
 void initAll();
+void driver_iterate();
+void ez_screen_iterate();
 
 // declaring intake variables
-inline int intake_vltg = 0;
+inline actuator_command intake_command;
+inline intake_machine intake;  // The jam state machine, only the intake executive callback touches it
 
 // declaring intake functions
-void set_intake(int vltg);
+void set_intake(actuator_command command);
 void control_intake();
-void intake_t();
+void intake_iterate();
+void intake_print();
+
+// Defining rollers constants
+#define ROLLERS_DRIVER_BPS 4.5  // blocks per second the driver runs the rollers at, 5 is a green motor's top speed
 
 // declaring rollers variables
-inline int rollers_vltg = 0;
+inline blocks_per_second rollers_throughput(0.0);
+inline roller_group rollers;  // Only the rollers executive callback touches it
 
 // declaring rollers functions
-void set_rollers(int vltg);
+void set_rollers(blocks_per_second throughput);
 void control_rollers();
-void rollers_t();
+void rollers_init();
+void rollers_iterate();
+void rollers_print();
 
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "loop_timer.hpp"
+
+// ** @file executive.hpp
+// ** @brief This file contains the function headers for the fixed-rate control executive.
+// ** @details Every subsystem loop registers a callback and a rate here instead of running its own
+// while(true) / pros::delay loop. One task wakes every EXEC_TICK ms with pros::Task::delay_until and runs
+// whatever is due, in the order the callbacks were added.
+// ** @author Ansh Rao - 2145Z
+
+// Defining the executive base tick, every callback period is rounded up to a multiple of this
+#define EXEC_TICK 5
+
+// declaring executive callback struct
+struct exec_callback {
+    std::function<void()> fn;
+    uint32_t period;          // ms between runs
+    uint64_t next_run = 0;    // pros::micros() timestamp this callback is next due
+    uint32_t jitter_worst = 0;  // furthest start from schedule, in us
+    uint64_t jitter_total = 0;
+    uint32_t overruns = 0;    // runs whose body took longer than the period
+    uint32_t skipped = 0;     // runs dropped because the executive fell a whole period behind
+    loop_timer timer;
+
+    exec_callback(std::string name, uint32_t period, std::function<void()> fn) : fn(fn), period(period), timer(name) {}
+};
+
+// declaring executive variables
+inline std::vector<exec_callback> exec_callbacks;
+inline bool exec_running = false;
+
+// declaring executive functions
+void exec_add(std::string name, uint32_t rate_hz, std::function<void()> fn);
+void exec_start();
+void exec_print();
+void exec_reset();
+void exec_t();
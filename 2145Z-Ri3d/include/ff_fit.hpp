@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// ** @file ff_fit.hpp
+// ** @brief This file contains the least squares fit for drive feedforward constants.
+// ** @details Tests are recorded as positions and the output that was applied, and the fit finds the kS, kV and kA
+// that best explain every one of them at once.
+// ** @author Ansh Rao - 2145Z
+//
+// output = kS * sgn(vel) + kV * vel + kA * acc could be fit directly, but acceleration is position differentiated
+// twice and encoder noise in it drags kA towards zero. Instead the fit predicts how fast the robot will be going a
+// short interval later, vel_next = alpha * vel + beta * output + gamma * sgn(vel), which only needs velocity. Held
+// for the interval, the feedforward model gives exactly alpha = e^(-kV / kA * interval), beta = (1 - alpha) / kV and
+// gamma = -kS * beta, so the constants come straight back out. It's linear in alpha, beta and gamma, so the fit
+// only keeps the sums of the normal equations and solves a 3x3 system at the end. Nothing is stored per sample.
+
+// Defining feedforward fit constants
+#define FF_FIT_MIN_VEL 1.0  // in/s or deg/s, slower samples don't say which way kS pushes
+#define FF_FIT_MIN_SAMPLES 50
+
+// declaring feedforward gains struct
+struct ff_gains {
+    double kS = 0.0;  // output to overcome static friction
+    double kV = 0.0;  // output per unit of velocity
+    double kA = 0.0;  // output per unit of acceleration
+};
+
+// declaring feedforward fit struct
+struct ff_fit {
+    double ata[3][3] = {};  // sums of the normal equations
+    double atb[3] = {};
+    double btb = 0.0;       // sum of vel_next squared, for r^2
+    double b = 0.0;         // sum of vel_next, for r^2
+    double interval = 0.0;  // s between vel and vel_next, every sample has to use the same one
+    int samples = 0;
+};
+
+// @brief Adds one sample to a fit
+// @param fit The fit
+// @param vel The measured velocity
+// @param output The average output over the interval, at BATTERY_NOMINAL
+// @param vel_next The measured velocity one interval later
+inline void ff_fit_add(ff_fit& fit, double vel, double output, double vel_next) {
+    if (std::fabs(vel) < FF_FIT_MIN_VEL) {return;}
+    const double row[3] = {vel, output, vel > 0.0 ? 1.0 : -1.0};
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {fit.ata[i][j] += row[i] * row[j];}
+        fit.atb[i] += row[i] * vel_next;
+    }
+    fit.btb += vel_next * vel_next;
+    fit.b += vel_next;
+    fit.samples++;
+}
+
+// @brief Adds a recorded test to a fit
+// @param fit The fit
+// @param pos Positions sampled every dt
+// @param output The output applied after each sample, at BATTERY_NOMINAL
+// @param dt Seconds between samples
+// @param span Samples either side of each velocity's central difference
+// @details Velocities are central differences over span samples either side, which smooths out the encoder ticks.
+// Each one is paired with the next that shares no samples with it, 2 * span + 1 samples later, so their noise is
+// independent.
+inline void ff_fit_series(ff_fit& fit, const std::vector<double>& pos, const std::vector<double>& output, double dt, size_t span) {
+    const size_t gap = 2 * span + 1;
+    if (span == 0 || pos.size() != output.size() || pos.size() <= 2 * span + gap) {return;}
+    fit.interval = gap * dt;
+    for (size_t i = span; i + gap + span < pos.size(); i++) {
+        double vel = (pos[i + span] - pos[i - span]) / (2.0 * span * dt);
+        double vel_next = (pos[i + gap + span] - pos[i + gap - span]) / (2.0 * span * dt);
+        double applied = 0.0;
+        for (size_t j = i; j < i + gap; j++) {applied += output[j];}
+        ff_fit_add(fit, vel, applied / gap, vel_next);
+    }
+}
+
+// @brief Solves a fit
+// @param fit The fit
+// @param gains Set to the constants if the fit solved
+// @param r2 Set to how much of vel_next the fit explains, 1 is all of it
+// @return False if there weren't enough samples, or they couldn't tell the constants apart
+inline bool ff_fit_solve(const ff_fit& fit, ff_gains& gains, double& r2) {
+    if (fit.samples < FF_FIT_MIN_SAMPLES || fit.interval <= 0.0) {return false;}
+
+    // Gaussian elimination with partial pivoting on [ata | atb]
+    double m[3][4];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {m[i][j] = fit.ata[i][j];}
+        m[i][3] = fit.atb[i];
+    }
+    for (int col = 0; col < 3; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < 3; row++) {
+            if (std::fabs(m[row][col]) > std::fabs(m[pivot][col])) {pivot = row;}
+        }
+        if (std::fabs(m[pivot][col]) < 1e-9 * (fit.ata[col][col] + 1.0)) {return false;}
+        for (int j = 0; j < 4; j++) {std::swap(m[col][j], m[pivot][j]);}
+        for (int row = 0; row < 3; row++) {
+            if (row == col) {continue;}
+            double factor = m[row][col] / m[col][col];
+            for (int j = col; j < 4; j++) {m[row][j] -= factor * m[col][j];}
+        }
+    }
+    const double x[3] = {m[0][3] / m[0][0], m[1][3] / m[1][1], m[2][3] / m[2][2]};
+    const double alpha = x[0], beta = x[1], gamma = x[2];
+    if (alpha <= 0.0 || alpha >= 1.0 || beta <= 0.0) {return false;}  // Not something a drive could do
+
+    // Residual sum of squares from the sums, b'b - 2x'A'b + x'A'Ax
+    double sse = fit.btb;
+    for (int i = 0; i < 3; i++) {
+        sse -= 2.0 * x[i] * fit.atb[i];
+        for (int j = 0; j < 3; j++) {sse += x[i] * fit.ata[i][j] * x[j];}
+    }
+    double sst = fit.btb - fit.b * fit.b / fit.samples;
+    r2 = sst > 0.0 ? 1.0 - sse / sst : 0.0;
+
+    gains.kV = (1.0 - alpha) / beta;
+    gains.kA = -gains.kV * fit.interval / std::log(alpha);
+    gains.kS = -gamma / beta;
+    return true;
+}
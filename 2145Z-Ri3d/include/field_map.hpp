@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "pose_ekf.hpp"
+
+// ** @file field_map.hpp
+// ** @brief This file contains the field walls and the distance sensor correction that uses them.
+// ** @details Coordinates are the same as the GPS uses, inches with the origin at the center of the field, x to the
+// right and y forwards from the red driver station's view of the field.
+// ** @author Ansh Rao - 2145Z
+
+// Defining field constants
+#define FIELD_HALF 70.2  // Center to the inside of the perimeter, six 23.4" tiles across
+
+// declaring field wall struct
+struct field_wall {
+    double x1, y1;
+    double x2, y2;
+};
+
+// declaring sensor mount struct
+struct sensor_mount {
+    double x;      // inches right of the tracking center
+    double y;      // inches forward of the tracking center
+    double theta;  // degrees the sensor points, clockwise from the front of the robot
+};
+
+// declaring reloc settings struct
+struct reloc_settings {
+    double min_incidence = 0.6;  // cos of the steepest angle to a wall that's still trusted, about 53 degrees
+    double ambiguity = 4.0;      // inches, readings that could be two different walls this close together are skipped
+    double gate = 3.0;           // readings this many sigma from where odometry expects the wall are skipped
+};
+
+// Push Back perimeter, only the walls. Field elements aren't in the map, readings off them fail the gate.
+inline constexpr field_wall push_back_walls[] = {
+    {-FIELD_HALF, -FIELD_HALF, FIELD_HALF, -FIELD_HALF},
+    {FIELD_HALF, -FIELD_HALF, FIELD_HALF, FIELD_HALF},
+    {FIELD_HALF, FIELD_HALF, -FIELD_HALF, FIELD_HALF},
+    {-FIELD_HALF, FIELD_HALF, -FIELD_HALF, -FIELD_HALF},
+};
+
+// declaring field hit struct
+struct field_hit {
+    double distance = -1.0;  // inches along the ray, negative if nothing was hit
+    double incidence = 0.0;  // cos of the angle between the ray and the wall's normal
+    double second = -1.0;    // distance to the next closest wall, negative if there isn't one
+};
+
+// @brief Casts a ray against the field walls
+// @param walls The walls to check
+// @param count How many walls there are
+// @param px, py Where the ray starts
+// @param heading The direction of the ray in degrees, 0 is +y and clockwise is positive
+// @return The closest wall the ray hits
+inline field_hit field_raycast(const field_wall* walls, size_t count, double px, double py, double heading) {
+    double ux = std::sin(heading * M_PI / 180.0);
+    double uy = std::cos(heading * M_PI / 180.0);
+    field_hit hit;
+    for (size_t i = 0; i < count; i++) {
+        double ex = walls[i].x2 - walls[i].x1, ey = walls[i].y2 - walls[i].y1;
+        double denom = ux * ey - uy * ex;
+        if (std::fabs(denom) < 1e-9) {continue;}  // Parallel to the wall
+        double wx = walls[i].x1 - px, wy = walls[i].y1 - py;
+        double t = (wx * ey - wy * ex) / denom;
+        double s = (wx * uy - wy * ux) / denom;
+        if (t <= 0.0 || s < 0.0 || s > 1.0) {continue;}
+
+        if (hit.distance < 0.0 || t < hit.distance) {
+            hit.second = hit.distance;
+            hit.distance = t;
+            hit.incidence = std::fabs(denom) / std::hypot(ex, ey);
+        } else if (hit.second < 0.0 || t < hit.second) {
+            hit.second = t;
+        }
+    }
+    return hit;
+}
+
+// @brief Works out where a distance sensor should see the wall from a pose
+// @param x, y, theta The robot's pose
+// @param mount Where the sensor is on the robot
+// @param walls, count The field map
+// @return The wall the sensor should see
+inline field_hit reloc_expected(double x, double y, double theta, const sensor_mount& mount, const field_wall* walls, size_t count) {
+    double s = std::sin(theta * M_PI / 180.0), c = std::cos(theta * M_PI / 180.0);
+    double sx = x + mount.y * s + mount.x * c;
+    double sy = y + mount.y * c - mount.x * s;
+    return field_raycast(walls, count, sx, sy, theta + mount.theta);
+}
+
+// @brief Corrects the pose with one distance sensor reading
+// @param ekf The filter to correct
+// @param mount Where the sensor is on the robot
+// @param measured The distance the sensor read in inches
+// @param var How unsure the reading is, in^2
+// @param walls, count The field map
+// @param settings When a reading is trusted
+// @return True if the reading was used
+// @details The expected distance is linearised about the current pose with finite differences, then applied as one
+// scalar EKF update. Readings are skipped when the wall is hit at a grazing angle, when two walls are about the same
+// distance away (a corner), or when the reading is too far from what odometry expects (a field element or robot).
+inline bool reloc_correct(pose_ekf& ekf, const sensor_mount& mount, double measured, double var, const field_wall* walls, size_t count,
+                          const reloc_settings& settings) {
+    field_hit expected = reloc_expected(ekf.x, ekf.y, ekf.theta, mount, walls, count);
+    if (expected.distance < 0.0 || expected.incidence < settings.min_incidence) {return false;}
+    if (expected.second >= 0.0 && expected.second - expected.distance < settings.ambiguity) {return false;}
+
+    const double step[3] = {0.1, 0.1, 0.1};  // inches, inches, degrees
+    double H[3];
+    for (int i = 0; i < 3; i++) {
+        double d[3] = {0.0, 0.0, 0.0};
+        d[i] = step[i];
+        field_hit moved = reloc_expected(ekf.x + d[0], ekf.y + d[1], ekf.theta + d[2], mount, walls, count);
+        if (moved.distance < 0.0) {return false;}
+        H[i] = (moved.distance - expected.distance) / step[i];
+    }
+    return ekf_update_innovation(ekf, H, measured - expected.distance, var, settings.gate);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// ** @file flight_log.hpp
+// ** @brief This file contains the binary flight log format shared by the recorder and the decoder in tools/.
+// ** @details This header must not include anything from PROS or EZ-Template so it builds on a laptop too. The same
+// goes for every header under include/ that tools/ includes, that's how the sims run the robot's own code.
+// ** @author Ansh Rao - 2145Z
+//
+// Layout (all multi-byte fields little endian):
+//   file header   "2145ZLOG", u8 version, u16 channel count,
+//                 then per channel: u8 name length, name, f32 scale
+//   block         u8 'B', u16 payload bytes, u16 record count, payload
+//   record        changed-channel bitmask (1 bit per channel, LSB first),
+//                 then a zigzag varint delta for every changed channel
+// Each channel is stored as round(value * scale). Deltas restart from 0 at the start of every block,
+// so a truncated file still decodes up to its last complete block.
+
+// Defining flight log constants
+#define FLIGHT_LOG_MAGIC "2145ZLOG"
+#define FLIGHT_LOG_VERSION 1
+#define FLIGHT_LOG_BLOCK 4096  // max payload bytes per block
+#define FLIGHT_LOG_MAX_CHANNELS 256
+
+// @brief Writes a value as an unsigned LEB128 varint
+// @return The number of bytes written
+inline size_t flight_log_varint_put(uint8_t* out, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    out[n++] = value;
+    return n;
+}
+
+// @brief Reads an unsigned LEB128 varint
+// @return The number of bytes read, or 0 if the varint runs past end
+inline size_t flight_log_varint_get(const uint8_t* in, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (size_t n = 0; n < 5 && in + n < end; n++) {
+        value |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+        if (!(in[n] & 0x80)) {return n + 1;}
+    }
+    return 0;
+}
+
+// @brief Maps signed values onto unsigned ones so small negatives stay small
+inline uint32_t flight_log_zigzag(int32_t value) { return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31); }
+inline int32_t flight_log_unzigzag(uint32_t value) { return (int32_t)(value >> 1) ^ -(int32_t)(value & 1); }
+
+// @brief Writes a little endian u16
+inline void flight_log_u16_put(uint8_t* out, uint16_t value) {
+    out[0] = value & 0xFF;
+    out[1] = value >> 8;
+}
+
+inline uint16_t flight_log_u16_get(const uint8_t* in) { return in[0] | (in[1] << 8); }
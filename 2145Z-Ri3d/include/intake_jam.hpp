@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// ** @file intake_jam.hpp
+// ** @brief This file contains the intake state machine that finds jams and clears them.
+// ** @details Times are milliseconds, current is mA, velocity is rpm and temperature is degrees C, the same units the
+// motor reports.
+// ** @author Ansh Rao - 2145Z
+//
+// A jam is the motor pulling a lot of current while barely turning, for long enough that it isn't just a block
+// squeezing through. The intake stops for a moment, runs backwards to let the block go, then starts again. Each jam
+// in a row reverses for longer, in case the first pulse didn't back the block out far enough. If it keeps jamming it
+// stays stopped until whoever is running it lets go, so a block that's properly stuck doesn't cook the motor.
+
+// declaring intake state enum
+enum intake_state {
+    INTAKE_IDLE = 0,
+    INTAKE_INTAKING,
+    INTAKE_JAMMED,     // stopped, either before a reverse pulse or for good after too many jams
+    INTAKE_REVERSING,  // running backwards to clear a jam
+    INTAKE_OUTTAKING,
+};
+
+// declaring intake settings struct
+struct intake_settings {
+    double stall_current = 2000.0;  // mA, the motor's limit is 2500 when it's cool
+    double stall_velocity = 60.0;   // rpm, 10% of a blue motor's free speed
+    uint32_t stall_time = 150;      // ms the motor has to be stalled for before it's a jam
+    uint32_t spinup_time = 250;     // ms after starting where stalls are ignored, the motor pulls a lot getting going
+    uint32_t settle_time = 50;      // ms stopped before reversing
+    uint32_t reverse_time = 200;    // ms to reverse for, longer every jam in a row
+    int reverse_voltage = -8000;    // mV
+    int max_retries = 3;            // jams in a row before giving up
+    uint32_t clear_time = 500;      // ms of intaking without a jam before the retries start over, plus the last reverse
+};
+
+// declaring intake stats struct
+struct intake_stats {
+    uint32_t jams = 0;
+    uint32_t lockouts = 0;  // times it gave up
+};
+
+// declaring intake machine struct
+struct intake_machine {
+    intake_settings settings;
+    intake_state state = INTAKE_IDLE;
+    uint32_t state_start = 0;  // ms
+    uint32_t stall_start = 0;  // ms, when the motor last wasn't stalled
+    int retries = 0;
+    bool locked = false;
+    intake_stats stats;
+};
+
+// @brief How much of its current limit the motor still has at a temperature
+// @param temperature The motor's temperature in degrees C
+// @details The V5 motor halves its current limit at 55C, and halves it again every 5C after until it stops at 70C.
+// A hot motor can't reach stall_current, so the threshold comes down with it.
+inline double intake_current_fraction(double temperature) {
+    if (temperature >= 70.0) {return 0.0;}
+    if (temperature >= 65.0) {return 0.125;}
+    if (temperature >= 60.0) {return 0.25;}
+    if (temperature >= 55.0) {return 0.5;}
+    return 1.0;
+}
+
+// @brief Changes the state the intake machine is in
+inline void intake_enter(intake_machine& machine, intake_state state, uint32_t now) {
+    machine.state = state;
+    machine.state_start = now;
+    machine.stall_start = now;
+}
+
+// @brief Runs one iteration of the intake state machine
+// @param machine The machine
+// @param now The time in ms
+// @param command The voltage the driver or auton wants in mV, positive intakes
+// @param current The motor's current draw in mA
+// @param velocity The motor's velocity in rpm
+// @param temperature The motor's temperature in degrees C
+// @return The voltage to send to the motor in mV
+// @details Letting go of the intake or outtaking always wins straight away, and clears a lockout. Only the sign of
+// command changes the state, what it returns while intaking is command itself.
+inline int intake_update(intake_machine& machine, uint32_t now, int command, double current, double velocity, double temperature) {
+    const intake_settings& s = machine.settings;
+    if (command <= 0) {
+        intake_state state = command < 0 ? INTAKE_OUTTAKING : INTAKE_IDLE;
+        if (machine.state != state) {intake_enter(machine, state, now);}
+        machine.retries = 0;
+        machine.locked = false;
+        return command;
+    }
+
+    if (machine.state == INTAKE_IDLE || machine.state == INTAKE_OUTTAKING) {intake_enter(machine, INTAKE_INTAKING, now);}
+
+    if (machine.state == INTAKE_INTAKING) {
+        uint32_t running = now - machine.state_start;
+        bool stalled = running >= s.spinup_time && std::fabs(velocity) < s.stall_velocity &&
+                       current >= s.stall_current * intake_current_fraction(temperature);
+        if (!stalled) {machine.stall_start = now;}
+        // After a reverse it takes about as long to get back to the block, so a block that's still stuck has had
+        // its chance to stall the motor again by then
+        if (running >= s.clear_time + s.reverse_time * machine.retries) {machine.retries = 0;}
+
+        if (now - machine.stall_start >= s.stall_time) {
+            machine.stats.jams++;
+            if (++machine.retries > s.max_retries) {
+                machine.locked = true;
+                machine.stats.lockouts++;
+            }
+            intake_enter(machine, INTAKE_JAMMED, now);
+        }
+    }
+    if (machine.state == INTAKE_JAMMED && !machine.locked && now - machine.state_start >= s.settle_time) {
+        intake_enter(machine, INTAKE_REVERSING, now);
+    }
+    if (machine.state == INTAKE_REVERSING && now - machine.state_start >= s.reverse_time * machine.retries) {
+        intake_enter(machine, INTAKE_INTAKING, now);
+    }
+
+    switch (machine.state) {
+        case INTAKE_INTAKING: return command;
+        case INTAKE_REVERSING: return s.reverse_voltage;
+        default: return 0;
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// ** @file loop_timer.hpp
+// ** @brief This file contains the timer used to measure how long each control loop body takes.
+// ** @details Times come from pros::micros(), so they are accurate to 1us on the brain.
+// ** @author Ansh Rao - 2145Z
+
+// declaring loop timer struct
+struct loop_timer {
+    std::string name;
+    uint32_t count = 0;      // iterations measured
+    uint64_t total_us = 0;   // summed time of every iteration
+    uint32_t worst_us = 0;   // longest single iteration
+    uint32_t last_us = 0;    // most recent iteration
+    uint64_t start_time = 0;
+
+    loop_timer(std::string name) : name(name) {}
+
+    void start();
+    void stop();
+    void reset();
+    double mean_ns() const;
+    void print() const;
+};
+
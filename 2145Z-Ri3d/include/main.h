@@ -47,6 +47,22 @@
 #include "autons.hpp"
 #include "subsystems.hpp"
 #include "controls.hpp"
+#include "loop_timer.hpp"
+#include "executive.hpp"
+#include "telemetry.hpp"
+#include "recorder.hpp"
+#include "path_cache.hpp"
+#include "trajectory.hpp"
+#include "trajectories.hpp"
+#include "odometry.hpp"
+#include "startup.hpp"
+#include "calibration.hpp"
+#include "color_sort.hpp"
+#include "actuator.hpp"
+#include "battery.hpp"
+#include "profile_drive.hpp"
+#include "characterize.hpp"
+#include "pursuit_drive.hpp"
 
 
 /**
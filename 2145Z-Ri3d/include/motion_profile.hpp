@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+// ** @file motion_profile.hpp
+// ** @brief This file contains the trapezoidal and S-curve velocity profiles for straight drives.
+// ** @details Distances are inches and times are seconds. Everything is closed form, so sampling a profile costs the
+// same at any time and nothing is allocated.
+// ** @author Ansh Rao - 2145Z
+//
+// The S-curve is the trapezoid averaged over a window of accel / jerk seconds. Averaging a trapezoid's velocity
+// over a window turns each corner in its acceleration into a ramp with exactly that jerk, and since the window
+// averages to one it still covers the same distance. It takes one window longer than the trapezoid.
+
+// declaring motion profile sample struct
+struct profile_sample {
+    double pos = 0.0;  // in
+    double vel = 0.0;  // in/s
+    double acc = 0.0;  // in/s^2
+};
+
+// declaring motion profile struct
+struct motion_profile {
+    double distance = 0.0;  // in, negative drives backwards
+    double accel = 0.0;     // in/s^2
+    double peak = 0.0;      // in/s, the most the trapezoid reaches, less than max velocity on short drives
+    double t_accel = 0.0;   // s at the end of the trapezoid's acceleration
+    double t_cruise = 0.0;  // s at the end of its cruise
+    double t_end = 0.0;     // s at the end of the trapezoid
+    double window = 0.0;    // s the trapezoid is averaged over, 0 for a plain trapezoid
+};
+
+// @brief Makes a profile
+// @param distance Inches to drive, negative drives backwards
+// @param max_vel Max velocity in in/s
+// @param max_accel Max acceleration in in/s^2
+// @param max_jerk Max jerk in in/s^3, 0 or less for a trapezoid
+inline motion_profile profile_make(double distance, double max_vel, double max_accel, double max_jerk) {
+    motion_profile p;
+    double d = std::fabs(distance);
+    p.distance = distance;
+    p.accel = max_accel;
+    p.window = max_jerk > 0.0 ? max_accel / max_jerk : 0.0;
+
+    // Short drives never reach max velocity. They still cruise for at least one window, otherwise accelerating
+    // straight into braking would take twice max jerk once it's averaged.
+    double w = p.window;
+    p.peak = std::min(max_vel, max_accel * (std::sqrt(w * w + 4.0 * d / max_accel) - w) / 2.0);
+    p.t_accel = p.peak / max_accel;
+    p.t_cruise = p.t_accel + (p.peak > 0.0 ? (d - p.peak * p.peak / max_accel) / p.peak : 0.0);
+    p.t_end = p.t_cruise + p.t_accel;
+    return p;
+}
+
+// @brief How long a profile takes
+inline double profile_duration(const motion_profile& p) { return p.t_end + p.window; }
+
+// @brief Samples the trapezoid at a time, with its integral of position
+// @param q Set to the integral of position from 0 to t
+// @details Distances are unsigned here, profile_at() puts the direction back on
+inline profile_sample profile_trapezoid(const motion_profile& p, double t, double& q) {
+    const double a = p.accel, v = p.peak, d = std::fabs(p.distance);
+    const double t1 = p.t_accel, t2 = p.t_cruise, te = p.t_end;
+    const double d1 = 0.5 * a * t1 * t1;  // covered by the end of the acceleration
+    const double q1 = a * t1 * t1 * t1 / 6.0;
+    const double q2 = q1 + d1 * (t2 - t1) + 0.5 * v * (t2 - t1) * (t2 - t1);
+    const double q3 = q2 + d * (te - t2) - a * (te - t2) * (te - t2) * (te - t2) / 6.0;
+
+    profile_sample s;
+    if (t <= 0.0) {
+        q = 0.0;
+    } else if (t < t1) {
+        s = {0.5 * a * t * t, a * t, a};
+        q = a * t * t * t / 6.0;
+    } else if (t < t2) {
+        double dt = t - t1;
+        s = {d1 + v * dt, v, 0.0};
+        q = q1 + d1 * dt + 0.5 * v * dt * dt;
+    } else if (t < te) {
+        double left = te - t;
+        s = {d - 0.5 * a * left * left, a * left, -a};
+        q = q2 + d * (t - t2) - a * ((te - t2) * (te - t2) * (te - t2) - left * left * left) / 6.0;
+    } else {
+        s = {d, 0.0, 0.0};
+        q = q3 + d * (t - te);
+    }
+    return s;
+}
+
+// @brief Samples a profile
+// @param p The profile
+// @param t Seconds since the start
+// @return Where the robot should be, how fast it should be going and how hard it should be accelerating
+inline profile_sample profile_at(const motion_profile& p, double t) {
+    double q_now, q_then;
+    profile_sample now = profile_trapezoid(p, t, q_now);
+    profile_sample s = now;
+    if (p.window > 0.0) {
+        // The average over the last window, from the integrals at each end of it
+        profile_sample then = profile_trapezoid(p, t - p.window, q_then);
+        s.pos = (q_now - q_then) / p.window;
+        s.vel = (now.pos - then.pos) / p.window;
+        s.acc = (now.vel - then.vel) / p.window;
+    }
+    double sign = p.distance < 0.0 ? -1.0 : 1.0;
+    return {s.pos * sign, s.vel * sign, s.acc * sign};
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cmath>
+
+// ** @file odom_math.hpp
+// ** @brief This file contains the odometry arc integrator.
+// ** @details Shared with tools/flight_replay.cpp, see flight_log.hpp. Everything is double precision.
+// ** @author Ansh Rao - 2145Z
+//
+// Conventions match EZ-Template: x is right, y is forward, theta is in degrees with 0 facing +y and
+// positive turning clockwise. Tracker offsets use the same sign as measure_offsets() computes them,
+// the distance a tracker reads divided by the angle turned (in radians) during a turn in place.
+
+// declaring odom state struct
+struct odom_state {
+    double x = 0.0;          // inches
+    double y = 0.0;          // inches
+    double theta = 0.0;      // degrees
+    double prev_vert = 0.0;  // last parallel tracker reading, inches
+    double prev_horiz = 0.0; // last perpendicular tracker reading, inches
+    double prev_theta = 0.0; // last heading, degrees
+};
+
+// @brief Resets the pose and remembers the current sensor readings as the starting point
+// @param state The odom state to reset
+// @param x, y, theta The pose to start at
+// @param vert, horiz, heading The current tracker readings and heading
+inline void odom_reset_state(odom_state& state, double x, double y, double theta, double vert, double horiz, double heading) {
+    state.x = x;
+    state.y = y;
+    state.theta = theta;
+    state.prev_vert = vert;
+    state.prev_horiz = horiz;
+    state.prev_theta = heading;
+}
+
+// @brief Works out how far the tracking center moved in the robot's frame over one sample
+// @param d_vert The change in the parallel tracker's reading in inches
+// @param d_horiz The change in the perpendicular tracker's reading in inches
+// @param d_theta_deg The change in heading in degrees
+// @param vert_offset The parallel tracker's distance to center
+// @param horiz_offset The perpendicular tracker's distance to center
+// @param local_x Set to the distance moved sideways, right is positive
+// @param local_y Set to the distance moved forwards
+inline void odom_arc_local(double d_vert, double d_horiz, double d_theta_deg, double vert_offset, double horiz_offset, double& local_x, double& local_y) {
+    double d_theta = d_theta_deg * M_PI / 180.0;
+    if (std::fabs(d_theta) < 1e-9) {
+        local_y = d_vert;
+        local_x = d_horiz;
+    } else {
+        // Chord length of the arc the tracking center travelled
+        double chord = 2.0 * std::sin(d_theta / 2.0);
+        local_y = chord * (d_vert / d_theta - vert_offset);
+        local_x = chord * (d_horiz / d_theta - horiz_offset);
+    }
+}
+
+// @brief Integrates one sample of tracker and heading readings as a constant-curvature arc
+// @param state The odom state to update
+// @param vert The parallel tracker's total distance in inches
+// @param horiz The perpendicular tracker's total distance in inches, 0 if there isn't one
+// @param heading The heading in degrees, unwrapped
+// @param vert_offset The parallel tracker's distance to center
+// @param horiz_offset The perpendicular tracker's distance to center
+inline void odom_arc_step(odom_state& state, double vert, double horiz, double heading, double vert_offset, double horiz_offset) {
+    double d_vert = vert - state.prev_vert;
+    double d_horiz = horiz - state.prev_horiz;
+    double d_theta_deg = heading - state.prev_theta;
+    state.prev_vert = vert;
+    state.prev_horiz = horiz;
+    state.prev_theta = heading;
+
+    double local_x, local_y;
+    odom_arc_local(d_vert, d_horiz, d_theta_deg, vert_offset, horiz_offset, local_x, local_y);
+
+    // Rotate into the field frame using the heading halfway through the arc
+    double avg = (state.theta + d_theta_deg / 2.0) * M_PI / 180.0;
+    state.x += local_y * std::sin(avg) + local_x * std::cos(avg);
+    state.y += local_y * std::cos(avg) - local_x * std::sin(avg);
+    state.theta += d_theta_deg;
+}
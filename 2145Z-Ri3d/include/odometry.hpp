@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "EZ-Template/api.hpp"
+#include "field_map.hpp"
+#include "loop_timer.hpp"
+#include "odom_math.hpp"
+#include "pose_ekf.hpp"
+#include "subsystems.hpp"
+
+// ** @file odometry.hpp
+// ** @brief This file contains the function headers for the high-rate odometry task.
+// ** @details EZ-Template integrates odometry in its own tracking task every 10ms. This task runs faster and at a
+// higher priority, reads the tracking wheels, drive encoders, IMU, GPS and distance sensors directly, and fuses them
+// with the EKF in pose_ekf.hpp. The pose and its covariance are published through a seqlock so anything can read them without
+// blocking the odom task.
+// ** @author Ansh Rao - 2145Z
+
+// Defining odometry constants
+#define ODOM_PERIOD 5             // ms between odometry updates, 200Hz
+#define ODOM_DATA_RATE 5          // ms between rotation sensor and IMU samples, 5 is the fastest they go
+#define ODOM_GPS_PERIOD 20        // ms between GPS fixes
+#define ODOM_GPS_MAX_ERROR 0.05   // GPS fixes the sensor reports as worse than this many meters are ignored
+#define ODOM_GPS_THETA_VAR 4.0    // deg^2, how much the GPS heading is trusted
+#define ODOM_GATE 4.0             // measurements further than this many sigma from the estimate are ignored
+#define ODOM_RESET_VAR_XY 0.25    // in^2, how unsure a pose set with odom_fast_xyt_set() is
+#define ODOM_RESET_VAR_THETA 0.25 // deg^2
+#define ODOM_RELOC_PERIOD 50      // ms between distance sensor corrections
+#define ODOM_RELOC_BUDGET 300     // us the distance sensor corrections can take per update
+#define ODOM_RELOC_CONFIDENCE 45  // distance sensor confidence out of 63 needed to use a reading
+#define ODOM_RELOC_MAX_RANGE 1500 // mm, the sensor gets noisy past this
+
+// declaring odom estimate struct
+struct odom_estimate {
+    ez::pose pose;
+    double cov[3][3];  // covariance of x, y and theta, in^2 and deg^2
+};
+
+// declaring pose seqlock struct
+// - only the odom task writes, readers retry if they catch it halfway through a write
+struct pose_seqlock {
+    std::atomic<uint32_t> seq{0};  // odd while a write is in progress
+    std::atomic<double> values[9] = {};  // x, y, theta, then the upper triangle of the covariance
+
+    void write(const pose_ekf& ekf);
+    odom_estimate read() const;
+};
+
+// declaring odom readings struct
+struct odom_readings {
+    double vert = 0.0;     // parallel tracking wheel, inches
+    double horiz = 0.0;    // perpendicular tracking wheel, inches
+    double left = 0.0;     // left drive encoders, inches
+    double right = 0.0;    // right drive encoders, inches
+    double heading = 0.0;  // IMU, degrees
+};
+
+// declaring reloc sensor struct
+struct reloc_sensor {
+    pros::Distance* sensor;
+    sensor_mount mount;
+    uint32_t used = 0;     // readings that corrected the pose
+    uint32_t skipped = 0;  // readings that were thrown out
+};
+
+// declaring odometry variables
+inline pose_seqlock odom_pose;
+inline pose_ekf odom_ekf;           // only touched by the odom task
+inline odom_readings odom_last;     // only touched by the odom task
+inline ekf_noise odom_noise;
+inline bool odom_use_trackers = false;  // false uses only the drive encoders
+inline bool odom_gps_enabled = false;   // only turn this on once the pose is set in field coordinates, see odom_gps_update()
+inline bool odom_reloc_enabled = false;  // same as odom_gps_enabled, the walls are in field coordinates
+inline reloc_settings odom_reloc_settings;
+inline std::vector<reloc_sensor> odom_reloc_sensors = {
+    {&opticalSort, {0.0, 6.0, 0.0}},  // Measure where it's mounted on the robot before turning this on
+};
+inline std::atomic<bool> odom_reset_pending{false};
+inline ez::pose odom_reset_pose;  // written before odom_reset_pending is set
+inline std::atomic<bool> odom_hold{false};  // set while the sensors are reset, the task only re-reads its baselines
+inline std::atomic<bool> odom_rebase_pending{false};  // the next sample only re-reads the baselines, the pose is kept
+inline loop_timer odom_timer("odom");
+
+// declaring odometry functions
+void odom_start();
+ez::pose odom_fast_get();
+odom_estimate odom_estimate_get();
+void odom_fast_xyt_set(double x, double y, double theta);
+void odom_fast_reset(double x, double y, double theta);
+void odom_sensor_reset();
+void odom_t();
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "EZ-Template/api.hpp"
+#include "pursuit.hpp"
+
+// ** @file path_cache.hpp
+// ** @brief This file contains the function headers for pre-generating pure pursuit paths.
+// ** @details pid_odom_set() with a list of points injects and smooths the whole path on the brain when the motion
+// starts. Paths added here are generated once in initialize(), so starting the motion only looks the path up. Each
+// path is kept as EZ-Template points for pid_odom_cached_set() and as measured path_points for pid_pursuit_set().
+// ** @author Ansh Rao - 2145Z
+
+// declaring cached path struct
+struct cached_path {
+    // Key, the path is regenerated if any of these change
+    ez::pose start;
+    std::vector<ez::odom> waypoints;
+    double spacing;
+    std::vector<double> smooth_constants;  // weight_smooth, weight_data, tolerance
+
+    // Injected and smoothed points, ready for pid_odom_pp_set()
+    std::vector<ez::odom> points;
+
+    // The same points measured for pid_pursuit_set(), and what they were planned with: the average kS and kV from
+    // traj_k and pursuit_k's max_accel, max_decel and max_lateral
+    std::vector<path_point> pursuit;
+    std::vector<double> plan_constants;
+};
+
+// declaring path cache variables
+inline std::vector<cached_path> path_cache;
+
+// declaring path cache functions
+int path_cache_add(std::vector<ez::united_odom> path, ez::united_pose start = {0_in, 0_in});
+int path_cache_find(std::vector<ez::united_odom> path, ez::united_pose start = {0_in, 0_in});
+void pid_odom_cached_set(std::vector<ez::united_odom> path, bool slew_on = false, ez::united_pose start = {0_in, 0_in});
+std::vector<ez::odom> path_inject(ez::pose start, const std::vector<ez::odom>& waypoints, double spacing);
+std::vector<ez::odom> path_smooth(const std::vector<ez::odom>& path, double weight_smooth, double weight_data, double tolerance);
+std::vector<path_point> path_pursuit_points(const std::vector<ez::odom>& points);
+const std::vector<path_point>& path_cache_pursuit(int index);
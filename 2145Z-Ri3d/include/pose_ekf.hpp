@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cmath>
+
+// ** @file pose_ekf.hpp
+// ** @brief This file contains the extended Kalman filter that fuses the odometry sources into one pose.
+// ** @details Like odom_math.hpp there are no PROS or EZ-Template includes here, so the filter can be replayed
+// on a laptop. The state is x and y in inches and theta in degrees, in EZ-Template's conventions.
+// ** @author Ansh Rao - 2145Z
+//
+// Prediction moves the pose along the arc odom_math.hpp works out and grows the covariance with distance
+// travelled. Anything that measures part of the pose directly (GPS, wall distances) is applied with
+// ekf_update(), one scalar at a time.
+
+// declaring pose ekf struct
+struct pose_ekf {
+    double x = 0.0;      // inches
+    double y = 0.0;      // inches
+    double theta = 0.0;  // degrees, unwrapped
+    double P[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};  // covariance, in^2 and deg^2
+};
+
+// declaring ekf noise struct
+struct ekf_noise {
+    double tracker_var = 0.0004;     // in^2 of error per inch a tracking wheel rolls
+    double ime_var = 0.01;           // in^2 of error per inch the drive encoders roll, they slip
+    double slip_sigma = 3.0;         // trackers and drive encoders disagreeing by more than this many sigma is wheel slip
+    double imu_var = 0.0001;         // deg^2 of error per degree the IMU turns
+    double ime_theta_var = 0.05;     // deg^2 of error per degree the drive encoders say the robot turned
+    double imu_drift_var = 0.00001;  // deg^2 of drift added every sample
+};
+
+// @brief Resets the filter to a known pose
+// @param ekf The filter to reset
+// @param x, y, theta The pose to start at
+// @param var_xy How unsure the starting position is, in^2
+// @param var_theta How unsure the starting heading is, deg^2
+inline void ekf_reset(pose_ekf& ekf, double x, double y, double theta, double var_xy, double var_theta) {
+    ekf = pose_ekf();
+    ekf.x = x;
+    ekf.y = y;
+    ekf.theta = theta;
+    ekf.P[0][0] = var_xy;
+    ekf.P[1][1] = var_xy;
+    ekf.P[2][2] = var_theta;
+}
+
+// @brief Combines two measurements of the same thing, weighting each by how much it's trusted
+// @param a, var_a The first measurement and its variance
+// @param b, var_b The second measurement and its variance
+// @param var Set to the variance of the result
+// @return The combined measurement
+inline double ekf_fuse(double a, double var_a, double b, double var_b, double& var) {
+    if (var_a <= 0.0) {var = var_a; return a;}
+    if (var_b <= 0.0) {var = var_b; return b;}
+    var = var_a * var_b / (var_a + var_b);
+    return (a * var_b + b * var_a) / (var_a + var_b);
+}
+
+// @brief Moves the pose along one sample of odometry
+// @param ekf The filter to update
+// @param local_x The distance moved sideways in the robot's frame, from odom_arc_local()
+// @param local_y The distance moved forwards in the robot's frame, from odom_arc_local()
+// @param d_theta The change in heading in degrees
+// @param var_along, var_cross How unsure the forwards and sideways distances are, in^2
+// @param var_theta How unsure the change in heading is, deg^2
+inline void ekf_predict(pose_ekf& ekf, double local_x, double local_y, double d_theta, double var_along, double var_cross, double var_theta) {
+    double mid = (ekf.theta + d_theta / 2.0) * M_PI / 180.0;
+    double s = std::sin(mid), c = std::cos(mid);
+    ekf.x += local_y * s + local_x * c;
+    ekf.y += local_y * c - local_x * s;
+    ekf.theta += d_theta;
+
+    // Jacobian of the motion with respect to theta, the rest of F is the identity
+    double fx = (local_y * c - local_x * s) * M_PI / 180.0;
+    double fy = (-local_y * s - local_x * c) * M_PI / 180.0;
+
+    // P = F P F^T
+    double P[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {P[i][j] = ekf.P[i][j];}
+    }
+    double f[2] = {fx, fy};
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 3; j++) {ekf.P[i][j] = P[i][j] + f[i] * P[2][j];}
+    }
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {ekf.P[i][j] += ekf.P[i][2] * f[j];}
+    }
+    ekf.P[0][2] = ekf.P[2][0] = P[0][2] + fx * P[2][2];
+    ekf.P[1][2] = ekf.P[2][1] = P[1][2] + fy * P[2][2];
+
+    // + Q, the forwards and sideways noise rotated into the field frame
+    double along[2] = {s, c};
+    double cross[2] = {c, -s};
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {ekf.P[i][j] += var_along * along[i] * along[j] + var_cross * cross[i] * cross[j];}
+    }
+    ekf.P[2][2] += var_theta;
+}
+
+// @brief Corrects the pose with a measurement, given how far it is from what the filter expects
+// @param ekf The filter to update
+// @param H How the measurement changes with x, y and theta, linearised about the current pose
+// @param innovation The measurement minus what the filter expects it to be
+// @param var How unsure the measurement is
+// @param gate Measurements more than this many sigma from what the filter expects are thrown out, 0 to never throw out
+// @return True if the measurement was used
+inline bool ekf_update_innovation(pose_ekf& ekf, const double H[3], double innovation, double var, double gate = 0.0) {
+    // PH^T and S = HPH^T + R
+    double PH[3];
+    for (int i = 0; i < 3; i++) {PH[i] = ekf.P[i][0] * H[0] + ekf.P[i][1] * H[1] + ekf.P[i][2] * H[2];}
+    double S = H[0] * PH[0] + H[1] * PH[1] + H[2] * PH[2] + var;
+    if (S <= 0.0) {return false;}
+    if (gate > 0.0 && innovation * innovation > gate * gate * S) {return false;}
+
+    double K[3] = {PH[0] / S, PH[1] / S, PH[2] / S};
+    ekf.x += K[0] * innovation;
+    ekf.y += K[1] * innovation;
+    ekf.theta += K[2] * innovation;
+
+    // P = P - K S K^T, written this way it stays symmetric
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {ekf.P[i][j] -= K[i] * S * K[j];}
+    }
+    return true;
+}
+
+// @brief Corrects the pose with a measurement of one part of it
+// @param ekf The filter to update
+// @param H How the measurement depends on x, y and theta, z = H * state
+// @param z The measurement
+// @param var How unsure the measurement is
+// @param gate Measurements more than this many sigma from what the filter expects are thrown out, 0 to never throw out
+// @param wrap True if the measurement is an angle in degrees, the innovation is wrapped to +-180
+// @return True if the measurement was used
+inline bool ekf_update(pose_ekf& ekf, const double H[3], double z, double var, double gate = 0.0, bool wrap = false) {
+    double innovation = z - (H[0] * ekf.x + H[1] * ekf.y + H[2] * ekf.theta);
+    if (wrap) {innovation = std::remainder(innovation, 360.0);}
+    return ekf_update_innovation(ekf, H, innovation, var, gate);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "motion_profile.hpp"
+
+// ** @file profile_drive.hpp
+// ** @brief This file contains the function headers for motion profiled straight drives.
+// ** @details pid_profile_drive_set() drives a trapezoid or S-curve from motion_profile.hpp with the trajectory
+// follower's kS/kV/kA feedforward and a kP on position. When the profile ends the last bit is handed to
+// pid_drive_set(), so EZ-Template's exit conditions decide when it's settled and pid_wait() works as usual.
+// ** @author Ansh Rao - 2145Z
+
+// declaring profile constants struct
+struct profile_constants {
+    double max_vel;      // in/s
+    double max_accel;    // in/s^2
+    double max_jerk;     // in/s^3, 0 for a trapezoid
+    double kP;           // drive_set output per inch behind the profile
+    double k_heading;    // drive_set output per degree off heading
+    double chain;        // in before the end profile_wait_quick_chain() lets the next motion start
+    int settle_speed;    // max speed of the pid_drive_set() that settles the end
+};
+
+// declaring profile variables
+// - chain matches pid_drive_chain_constant_set() in default_constants()
+inline profile_constants profile_k = {60.0, 150.0, 3000.0, 15.0, 2.0, 3.0, 60};
+inline motion_profile profile_active;
+inline bool profile_running = false;
+inline uint32_t profile_start_time = 0;
+inline double profile_left_start = 0.0;   // in
+inline double profile_right_start = 0.0;  // in
+inline double profile_heading = 0.0;      // deg, held the whole way
+inline double profile_traveled = 0.0;     // in, updated by profile_iterate()
+inline double profile_handoff = 0.0;      // in traveled when pid_drive_set() took over
+
+// declaring profile functions
+void pid_profile_drive_set(okapi::QLength target);
+void pid_profile_drive_set(okapi::QLength target, double max_vel, double max_accel, double max_jerk);
+void profile_wait();
+void profile_wait_until(okapi::QLength target);
+void profile_wait_quick_chain();
+void profile_iterate();
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// ** @file pursuit.hpp
+// ** @brief This file contains the path point format and the searches for our pure pursuit follower.
+// ** @details Units and directions match EZ-Template odom: inches, degrees, theta 0 facing +y and positive clockwise.
+// ** @author Ansh Rao - 2145Z
+//
+// Both searches only move forward along the path and only look at a few points past where they were last tick, so
+// a tick costs the same on a 20 point path as on a 5000 point skills path. Everything that needs the whole path,
+// distance along it, curvature and how fast each point can be driven, is worked out once when the path is cached.
+
+// Defining pursuit search constants
+#define PURSUIT_WINDOW 20          // points past last tick's closest point the closest point search looks at, 10" at 0.5" spacing
+#define PURSUIT_CURVATURE_SPAN 4   // points either side curvature is measured across, neighbours are too close to say much
+#define PURSUIT_AHEAD 12.0         // in ahead of each point its upcoming curvature looks, the most lookahead can be
+
+// declaring path point struct
+struct path_point {
+    double x = 0.0;          // in
+    double y = 0.0;          // in
+    double s = 0.0;          // in along the path from its first point
+    double curvature = 0.0;  // 1/in, unsigned
+    double ahead = 0.0;      // 1/in, the most curvature in the next PURSUIT_AHEAD inches
+    double speed = 0.0;      // in/s, the waypoint's max_xy_speed
+    double vel = 0.0;        // in/s, the most path_plan() says it can go here
+    bool reversed = false;   // true if this part of the path is driven backwards
+};
+
+// declaring pursuit constants struct
+struct pursuit_constants {
+    double look_min;        // in
+    double look_max;        // in, at most PURSUIT_AHEAD
+    double look_per_speed;  // in of lookahead per in/s
+    double look_corner;     // lookahead is at most this many corner radii
+    double max_accel;       // in/s^2
+    double max_decel;       // in/s^2
+    double max_lateral;     // in/s^2 sideways before the wheels slide, v^2 * curvature
+    double handoff;         // in from the end EZ-Template's odom PID takes over
+    int settle_speed;       // max speed of the pid_odom_set() that settles the end
+};
+
+// declaring pursuit state struct
+// - both indexes only ever go up
+struct pursuit_state {
+    size_t closest = 0;  // the path point nearest the robot
+    size_t target = 0;   // the lookahead point is on the segment from this point to the next
+    int checked = 0;     // points the last tick looked at
+};
+
+// @brief Fills in distance along the path and curvature for every point
+// @param path The points, x, y, speed and reversed already set
+// @details Curvature is the circle through the points PURSUIT_CURVATURE_SPAN either side. The path's ends have no
+// points past them, so they use the nearest three that span far enough.
+inline void path_measure(std::vector<path_point>& path) {
+    const size_t n = path.size();
+    for (size_t i = 1; i < n; i++) {path[i].s = path[i - 1].s + std::hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);}
+
+    const size_t span = PURSUIT_CURVATURE_SPAN;
+    for (size_t i = 0; i < n; i++) {
+        if (n < 2 * span + 1) {
+            path[i].curvature = 0.0;
+            continue;
+        }
+        size_t mid = std::clamp(i, span, n - 1 - span);
+        const path_point& a = path[mid - span];
+        const path_point& b = path[mid];
+        const path_point& c = path[mid + span];
+        double cross = (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+        double sides = std::hypot(b.x - a.x, b.y - a.y) * std::hypot(c.x - b.x, c.y - b.y) * std::hypot(c.x - a.x, c.y - a.y);
+        path[i].curvature = sides > 1e-9 ? std::fabs(2.0 * cross / sides) : 0.0;
+    }
+
+    // The most curvature ahead, with a window that slides forward as i does
+    size_t end = 0;
+    std::vector<size_t> window;  // indexes with decreasing curvature
+    size_t front = 0;
+    for (size_t i = 0; i < n; i++) {
+        while (end < n && path[end].s - path[i].s <= PURSUIT_AHEAD) {
+            while (window.size() > front && path[window.back()].curvature <= path[end].curvature) {window.pop_back();}
+            window.push_back(end++);
+        }
+        while (window[front] < i) {front++;}
+        path[i].ahead = path[window[front]].curvature;
+    }
+}
+
+// @brief Plans how fast every point of the path can be driven
+// @param path A measured path, from path_measure()
+// @param k The constants, max_accel, max_decel and max_lateral are used
+// @details Each point starts at the most of its waypoint's speed and what max_lateral allows through its curvature.
+// A backward pass then slows points so the robot can brake in time for every corner and stop at the end, and a
+// forward pass so it only speeds back up at max_accel coming out of them. The first point keeps its limit, the
+// follower slews up from whatever the robot is doing.
+inline void path_plan(std::vector<path_point>& path, const pursuit_constants& k) {
+    const size_t n = path.size();
+    for (path_point& point : path) {
+        point.vel = point.speed;
+        if (point.curvature > 0.0) {point.vel = std::min(point.vel, std::sqrt(k.max_lateral / point.curvature));}
+    }
+    if (n == 0) {return;}
+
+    path[n - 1].vel = 0.0;
+    for (size_t i = n - 1; i-- > 0;) {
+        double ds = path[i + 1].s - path[i].s;
+        path[i].vel = std::min(path[i].vel, std::sqrt(path[i + 1].vel * path[i + 1].vel + 2.0 * k.max_decel * ds));
+    }
+    for (size_t i = 1; i < n; i++) {
+        double ds = path[i].s - path[i - 1].s;
+        path[i].vel = std::min(path[i].vel, std::sqrt(path[i - 1].vel * path[i - 1].vel + 2.0 * k.max_accel * ds));
+    }
+}
+
+// @brief Finds the path point nearest the robot
+// @param path The path
+// @param state closest is moved to the nearest of it and the next PURSUIT_WINDOW points
+// @param x, y Where the robot is
+inline void pursuit_closest(const std::vector<path_point>& path, pursuit_state& state, double x, double y) {
+    size_t last = std::min(path.size() - 1, state.closest + PURSUIT_WINDOW);
+    size_t best = state.closest;
+    double best_distance = INFINITY;
+    for (size_t i = state.closest; i <= last; i++) {
+        double distance = std::hypot(path[i].x - x, path[i].y - y);
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = i;
+        }
+    }
+    state.checked += last - state.closest + 1;
+    state.closest = best;
+}
+
+// @brief Picks how far ahead to look
+// @param k The constants
+// @param speed How fast the robot is going in in/s
+// @param curvature The most curvature coming up, path_point::ahead
+// @return Further the faster the robot goes, closer into tight corners so it doesn't cut them
+inline double pursuit_lookahead(const pursuit_constants& k, double speed, double curvature) {
+    double look = k.look_min + k.look_per_speed * std::fabs(speed);
+    if (curvature > 0.0) {look = std::min(look, k.look_corner / curvature);}
+    return std::clamp(look, k.look_min, std::min(k.look_max, PURSUIT_AHEAD));
+}
+
+// @brief Finds the lookahead point, where a circle around the robot leaves the path
+// @param path The path
+// @param state target is moved forward to the segment the lookahead point is on
+// @param x, y Where the robot is
+// @param look The lookahead distance
+// @param tx, ty Set to the lookahead point, the end of the path once the circle is past it
+inline void pursuit_target(const std::vector<path_point>& path, pursuit_state& state, double x, double y, double look, double& tx, double& ty) {
+    size_t i = std::max(state.target, state.closest);
+    while (i + 1 < path.size() && std::hypot(path[i + 1].x - x, path[i + 1].y - y) < look) {
+        i++;
+        state.checked++;
+    }
+    state.target = i;
+    if (i + 1 >= path.size()) {
+        tx = path.back().x;
+        ty = path.back().y;
+        return;
+    }
+
+    // Where the segment from i to i + 1 crosses the circle, the furthest along if it crosses twice
+    const path_point& a = path[i];
+    const path_point& b = path[i + 1];
+    double dx = b.x - a.x, dy = b.y - a.y;
+    double fx = a.x - x, fy = a.y - y;
+    double qa = dx * dx + dy * dy;
+    double qb = 2.0 * (fx * dx + fy * dy);
+    double qc = fx * fx + fy * fy - look * look;
+    double discriminant = qb * qb - 4.0 * qa * qc;
+    double t = 1.0;  // The robot is off the path by more than the lookahead, head for the next point
+    if (qa > 1e-12 && discriminant >= 0.0) {t = std::clamp((-qb + std::sqrt(discriminant)) / (2.0 * qa), 0.0, 1.0);}
+    tx = a.x + dx * t;
+    ty = a.y + dy * t;
+}
+
+// @brief Gets the fastest the robot can drive an arc
+// @param curvature 1/in
+// @param fastest in/s the fastest wheel can go
+// @param turn_radius in, trajectory_turn_radius()
+// @return in/s at the center that keeps the outside wheel at fastest
+inline double pursuit_speed_limit(double curvature, double fastest, double turn_radius) {
+    return fastest / (1.0 + std::fabs(curvature) * turn_radius);
+}
+
+// @brief Gets the curvature of the arc from the robot to the lookahead point
+// @param x, y, theta Where the robot is
+// @param tx, ty The lookahead point
+// @param reversed True if the robot is driving backwards
+// @return 1/in, positive turning clockwise while going the way the robot is driving
+inline double pursuit_curvature(double x, double y, double theta, double tx, double ty, bool reversed) {
+    double heading = (theta + (reversed ? 180.0 : 0.0)) * M_PI / 180.0;
+    double dx = tx - x, dy = ty - y;
+    double cross = dx * std::cos(heading) - dy * std::sin(heading);  // to the right of the way it's driving
+    double distance_squared = dx * dx + dy * dy;
+    return distance_squared > 1e-9 ? 2.0 * cross / distance_squared : 0.0;
+}
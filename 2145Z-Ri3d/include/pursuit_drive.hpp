@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "EZ-Template/api.hpp"
+#include "pursuit.hpp"
+
+// ** @file pursuit_drive.hpp
+// ** @brief This file contains the function headers for our pure pursuit follower.
+// ** @details pid_pursuit_set() follows a path from path_cache.hpp with pursuit.hpp's windowed searches and a
+// lookahead that grows with speed and shrinks into corners, driving the wheels with the trajectory follower's
+// feedforward at the speed path_plan() worked out for each point. The last few inches are handed to
+// pid_odom_ptp_set(), so EZ-Template settles the end and pid_wait() works as usual.
+// ** @author Ansh Rao - 2145Z
+//
+// EZ-Template's pure pursuit scans the whole path for the closest and lookahead points every tick and looks a fixed
+// distance ahead. On a long skills path that's thousands of points a tick, and one lookahead is either too short to
+// be stable at speed or long enough to cut every corner. tools/pursuit_sim.cpp compares the two.
+
+// declaring pursuit variables
+// - lookahead is 7" like odom_look_ahead_get() when slow, up to 12" at speed, and at most 0.7 corner radii
+// - max_lateral is ~0.4g, the speed through a 24" radius is ~60 in/s. Paths are planned when they're cached, set
+//   these before paths_init()
+inline pursuit_constants pursuit_k = {7.0, 12.0, 0.02, 0.7, 150.0, 150.0, 150.0, 4.0, 60};
+inline int pursuit_path = -1;  // index in path_cache
+inline pursuit_state pursuit_at;
+inline std::atomic<bool> pursuit_running = false;
+inline double pursuit_vel = 0.0;   // in/s the follower is asking for
+inline double pursuit_look = 0.0;  // in, this tick's lookahead
+
+// declaring pursuit functions
+void pid_pursuit_set(std::vector<ez::united_odom> path, ez::united_pose start = {0_in, 0_in});
+void pursuit_wait();
+void pursuit_wait_until_point(ez::united_pose target);
+void pursuit_stop();
+void pursuit_iterate();
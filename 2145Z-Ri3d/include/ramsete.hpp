@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cmath>
+
+// ** @file ramsete.hpp
+// ** @brief This file contains the RAMSETE control law for following a trajectory.
+// ** @details It takes the reference's velocity and turn rate and the robot's error from it, and gives the velocity
+// and turn rate to drive at. Units and directions match trajectory_iterate(): inches, degrees, theta clockwise.
+// ** @author Ansh Rao - 2145Z
+//
+// RAMSETE is nonlinear feedback for a robot that can't move sideways. Its gain grows with how fast the reference is
+// going and turning, so it corrects hard at speed and gently when nearly stopped, and the heading and cross track
+// terms are shaped so the error always converges. b is how aggressively it corrects, zeta is how damped that is.
+// The usual b = 2 rad^2/m^2 is 0.0013 per inch^2.
+
+// declaring ramsete gains struct
+struct ramsete_gains {
+    double b;     // per in^2, bigger corrects harder
+    double zeta;  // damping between 0 and 1
+};
+
+// declaring ramsete command struct
+struct ramsete_command {
+    double vel = 0.0;    // in/s
+    double omega = 0.0;  // deg/s, positive clockwise
+};
+
+// @brief Runs the RAMSETE control law
+// @param k The gains
+// @param ref_vel The reference velocity in in/s, negative driving backwards
+// @param ref_omega The reference turn rate in deg/s, positive clockwise
+// @param along Inches the reference is in front of the robot
+// @param cross Inches the reference is to the right of the robot
+// @param theta Degrees the reference's heading is clockwise of the robot's
+// @return The velocity and turn rate to drive at
+inline ramsete_command ramsete(const ramsete_gains& k, double ref_vel, double ref_omega, double along, double cross, double theta) {
+    double error = theta * M_PI / 180.0;
+    double omega = ref_omega * M_PI / 180.0;
+    double gain = 2.0 * k.zeta * std::sqrt(omega * omega + k.b * ref_vel * ref_vel);
+    double sinc = std::fabs(error) < 1e-6 ? 1.0 - error * error / 6.0 : std::sin(error) / error;
+
+    ramsete_command command;
+    command.vel = ref_vel * std::cos(error) + gain * along;
+    command.omega = ref_omega + (gain * error + k.b * ref_vel * sinc * cross) * 180.0 / M_PI;
+    return command;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+
+#include "telemetry.hpp"
+
+// ** @file recorder.hpp
+// ** @brief This file contains the function headers for the SD card flight recorder.
+// ** @details Telemetry frames are written to /usd/flNNN.bin in the format described in flight_log.hpp.
+// Decode them on a laptop with tools/flight_decode.cpp. Each time the robot is enabled a new log is started, and
+// it's closed when the robot is disabled, so autonomous and driver control get a file each.
+// ** @author Ansh Rao - 2145Z
+
+// declaring recorder variables
+inline FILE* recorder_file = nullptr;
+inline uint32_t recorder_bytes = 0;  // bytes written to the current log so far
+inline uint32_t recorder_start_ms = 0;
+inline std::atomic<bool> recorder_start_pending{false};  // set from any task, the telemetry task opens a new log
+inline std::atomic<bool> recorder_stop_pending{false};   // set from any task, the telemetry task closes the log
+
+// declaring recorder functions
+bool recorder_start();
+void recorder_write(const telemetry_frame& frame);
+void recorder_flush();
+void recorder_stop();
+void recorder_service();
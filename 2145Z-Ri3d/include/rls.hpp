@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+// ** @file rls.hpp
+// ** @brief This file contains a one parameter recursive least squares estimator.
+// ** @details It fits y = estimate * x one sample at a time, slowly forgetting old samples so the estimate follows
+// the robot as it gets rebuilt.
+// ** @author Ansh Rao - 2145Z
+
+// declaring rls struct
+struct rls1 {
+    double estimate = 0.0;
+    double P = 1.0;          // variance of the estimate, relative to the noise on y
+    double lambda = 0.999;   // forgetting factor, 1 never forgets
+    uint32_t samples = 0;
+
+    rls1() {}
+    rls1(double estimate, double P, double lambda) : estimate(estimate), P(P), lambda(lambda) {}
+};
+
+// @brief Adds one sample to the estimate
+// @param rls The estimator
+// @param x The input
+// @param y The measured output
+// @param gate Samples that miss the current estimate by more than this are thrown out, 0 to use every sample
+// @return True if the sample was used
+inline bool rls1_update(rls1& rls, double x, double y, double gate = 0.0) {
+    double error = y - rls.estimate * x;
+    if (gate > 0.0 && rls.samples > 0 && std::fabs(error) > gate) {return false;}
+    double gain = rls.P * x / (rls.lambda + x * rls.P * x);
+    rls.estimate += gain * error;
+    rls.P = (rls.P - gain * x * rls.P) / rls.lambda;
+    rls.samples++;
+    return true;
+}
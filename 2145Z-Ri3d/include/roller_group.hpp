@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+// ** @file roller_group.hpp
+// ** @brief This file contains the controller that runs both rollers together at a block throughput.
+// ** @details Positions are degrees, velocities are rpm and outputs are mV, the same units the motors use.
+// ** @author Ansh Rao - 2145Z
+//
+// In sync mode each roller closes its own velocity loop, and a cross coupling term slows whichever roller has got
+// ahead and speeds up the other, so a block is pushed by both ends of the chute the same amount and doesn't twist.
+// In share mode both rollers get the same voltage from their average velocity, so they split the load evenly
+// instead of the one with less on it running away.
+
+// Defining roller group constants
+#define ROLLER_MAX_MV 12000
+
+// declaring blocks per second type
+// - the constructor is explicit like the actuator command types, so a voltage can't be passed as a throughput
+struct blocks_per_second {
+    double value;
+    constexpr explicit blocks_per_second(double value) : value(value) {}
+};
+
+// declaring roller mode enum
+enum roller_mode {
+    ROLLERS_SYNC = 0,  // each roller closes velocity, plus a term that keeps their positions together
+    ROLLERS_SHARE,     // both rollers get the same voltage, so they share the torque
+};
+
+// declaring roller gains struct
+struct roller_gains {
+    double kS = 300.0;  // mV to get a roller moving
+    double kV = 60.0;   // mV per rpm, 12V over a green motor's 200rpm
+    double kP = 30.0;   // mV per rpm of velocity error
+    double kC = 20.0;   // mV per degree the rollers have drifted apart
+};
+
+// declaring roller output struct
+struct roller_output {
+    int first = 0;   // mV
+    int second = 0;  // mV
+};
+
+// declaring roller group struct
+struct roller_group {
+    roller_gains gains;
+    roller_mode mode = ROLLERS_SYNC;
+    double deg_per_block = 240.0;  // roller1 degrees per block, a block plus the gap to the next one
+    double ratio = 1.0;            // roller2 degrees per roller1 degree for the same block travel
+
+    bool synced = false;  // false until the offsets are taken again
+    double offset = 0.0;  // drift when the offsets were taken, roller1 degrees
+    double drift = 0.0;   // roller1 degrees roller1 is ahead of roller2
+    double drift_worst = 0.0;
+};
+
+// @brief Turns a block throughput into roller1's velocity
+// @return rpm of roller1
+inline double roller_rpm(const roller_group& group, blocks_per_second throughput) {
+    return throughput.value * group.deg_per_block / 6.0;
+}
+
+// @brief Starts syncing positions again from wherever the rollers are
+// @details Call it when the rollers have been running apart on purpose, like roller2 ejecting for the colour sort
+inline void roller_resync(roller_group& group) { group.synced = false; }
+
+// @brief Runs one iteration of the roller group
+// @param group The group
+// @param target roller1's target velocity in rpm, roller2's is this times ratio
+// @param first_position roller1's position in degrees
+// @param first_velocity roller1's velocity in rpm
+// @param second_position roller2's position in degrees
+// @param second_velocity roller2's velocity in rpm
+// @return The voltage for each roller
+inline roller_output roller_update(roller_group& group, double target, double first_position, double first_velocity, double second_position,
+                                   double second_velocity) {
+    const roller_gains& g = group.gains;
+    double drift = first_position - second_position / group.ratio;
+    if (!group.synced || target == 0.0) {
+        group.offset = drift;
+        group.synced = target != 0.0;
+    }
+    group.drift = drift - group.offset;
+    group.drift_worst = std::max(group.drift_worst, std::fabs(group.drift));
+    if (target == 0.0) {return {};}
+
+    double sign = target > 0.0 ? 1.0 : -1.0;
+    double first = g.kS * sign + g.kV * target;
+    double second = g.kS * sign + g.kV * target * group.ratio;
+    if (group.mode == ROLLERS_SHARE) {
+        double error = target - (first_velocity + second_velocity / group.ratio) / 2.0;
+        first += g.kP * error;
+        second += g.kP * error;
+    } else {
+        first += g.kP * (target - first_velocity) - g.kC * group.drift;
+        second += g.kP * (target * group.ratio - second_velocity) + g.kC * group.drift;
+    }
+
+    roller_output output;
+    output.first = (int)std::clamp(first, (double)-ROLLER_MAX_MV, (double)ROLLER_MAX_MV);
+    output.second = (int)std::clamp(second, (double)-ROLLER_MAX_MV, (double)ROLLER_MAX_MV);
+    return output;
+}
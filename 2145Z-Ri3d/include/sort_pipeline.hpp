@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ** @file sort_pipeline.hpp
+// ** @brief This file contains the colour sorting logic, from optical sensor readings to when to eject.
+// ** @details Positions are the roller encoder in degrees and only ever compared to each other, times are microseconds.
+// ** @author Ansh Rao - 2145Z
+
+// Defining sort pipeline constants
+#define SORT_FIFO_SIZE 8  // blocks that can be between the sensor and the exit at once
+
+// declaring block colour enum
+enum block_color {
+    BLOCK_NONE = 0,
+    BLOCK_RED,
+    BLOCK_BLUE,
+};
+
+// declaring sort settings struct
+struct sort_settings {
+    double red_hue = 10.0;           // degrees, red wraps around 0
+    double blue_hue = 220.0;         // degrees
+    double hue_enter = 25.0;         // a block is detected once the hue is this close to a colour
+    double hue_exit = 60.0;          // and stays detected until it's further than this
+    double proximity_enter = 180.0;  // optical proximity (0-255) to start a block
+    double proximity_exit = 120.0;   // proximity to end a block
+    double sensor_to_exit = 540.0;   // roller degrees from the sensor to the exit
+    double eject_length = 180.0;     // roller degrees to keep ejecting for
+};
+
+// declaring sorted block struct
+struct sorted_block {
+    block_color color;
+    double exit_position;  // roller position when the block reaches the exit
+    uint64_t detect_time;  // us
+};
+
+// declaring sort stats struct
+struct sort_stats {
+    uint32_t detected = 0;
+    uint32_t ejected = 0;
+    uint32_t dropped = 0;        // detections the FIFO had no room for
+    uint64_t latency_total = 0;  // us from detection to eject, summed
+    uint32_t latency_worst = 0;  // us
+    double late_worst = 0.0;     // roller degrees past the exit position an eject started
+};
+
+// declaring sort pipeline struct
+struct sort_pipeline {
+    sort_settings settings;
+    block_color eject_color = BLOCK_BLUE;  // the colour that isn't ours
+
+    block_color seen = BLOCK_NONE;  // the block in front of the sensor right now, after hysteresis
+    sorted_block fifo[SORT_FIFO_SIZE];
+    size_t head = 0;
+    size_t count = 0;
+    bool ejecting = false;
+    double eject_end = 0.0;
+    sort_stats stats;
+};
+
+// @brief How far a hue is from a target hue, both in degrees
+inline double sort_hue_distance(double hue, double target) {
+    return std::fabs(std::remainder(hue - target, 360.0));
+}
+
+// @brief Works out which block is in front of the sensor, with hysteresis so one block is one detection
+// @param pipeline The pipeline
+// @param hue The optical sensor's hue in degrees
+// @param proximity The optical sensor's proximity, 0 is nothing and 255 is touching
+// @return The colour of a block that just arrived, BLOCK_NONE if nothing new arrived
+inline block_color sort_classify(sort_pipeline& pipeline, double hue, double proximity) {
+    const sort_settings& s = pipeline.settings;
+    if (pipeline.seen != BLOCK_NONE) {
+        double target = pipeline.seen == BLOCK_RED ? s.red_hue : s.blue_hue;
+        if (proximity >= s.proximity_exit && sort_hue_distance(hue, target) <= s.hue_exit) {return BLOCK_NONE;}
+        pipeline.seen = BLOCK_NONE;  // The block has gone, or the next one is touching it
+    }
+    if (proximity < s.proximity_enter) {return BLOCK_NONE;}
+    if (sort_hue_distance(hue, s.red_hue) < s.hue_enter) {pipeline.seen = BLOCK_RED;}
+    else if (sort_hue_distance(hue, s.blue_hue) < s.hue_enter) {pipeline.seen = BLOCK_BLUE;}
+    return pipeline.seen;
+}
+
+// @brief Runs one iteration of the sorting pipeline
+// @param pipeline The pipeline
+// @param now The time in us
+// @param position The roller encoder in degrees, increasing as blocks move towards the exit
+// @param hue The optical sensor's hue in degrees
+// @param proximity The optical sensor's proximity
+// @return True while the exit should be ejecting
+// @details New blocks go into the FIFO with the roller position they'll be at the exit. When the roller gets there
+// the block is popped, and if it's the wrong colour the exit ejects for eject_length degrees. Blocks that leave
+// the other way (the rollers running backwards) are never popped early, the FIFO only moves forwards.
+inline bool sort_update(sort_pipeline& pipeline, uint64_t now, double position, double hue, double proximity) {
+    block_color arrived = sort_classify(pipeline, hue, proximity);
+    if (arrived != BLOCK_NONE) {
+        pipeline.stats.detected++;
+        if (pipeline.count < SORT_FIFO_SIZE) {
+            size_t tail = (pipeline.head + pipeline.count) % SORT_FIFO_SIZE;
+            pipeline.fifo[tail] = {arrived, position + pipeline.settings.sensor_to_exit, now};
+            pipeline.count++;
+        } else {
+            pipeline.stats.dropped++;
+        }
+    }
+
+    while (pipeline.count > 0 && position >= pipeline.fifo[pipeline.head].exit_position) {
+        const sorted_block& block = pipeline.fifo[pipeline.head];
+        if (block.color == pipeline.eject_color) {
+            pipeline.ejecting = true;
+            pipeline.eject_end = block.exit_position + pipeline.settings.eject_length;
+            uint32_t latency = now - block.detect_time;
+            pipeline.stats.ejected++;
+            pipeline.stats.latency_total += latency;
+            if (latency > pipeline.stats.latency_worst) {pipeline.stats.latency_worst = latency;}
+            double late = position - block.exit_position;
+            if (late > pipeline.stats.late_worst) {pipeline.stats.late_worst = late;}
+        }
+        pipeline.head = (pipeline.head + 1) % SORT_FIFO_SIZE;
+        pipeline.count--;
+    }
+
+    if (pipeline.ejecting && position >= pipeline.eject_end) {pipeline.ejecting = false;}
+    return pipeline.ejecting;
+}
+
+// @brief Clears every block from the pipeline, for when the rollers run backwards or the sort is turned off
+inline void sort_clear(sort_pipeline& pipeline) {
+    pipeline.seen = BLOCK_NONE;
+    pipeline.count = 0;
+    pipeline.ejecting = false;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "api.h"
+
+// ** @file startup.hpp
+// ** @brief This file contains the function headers for running the slow parts of initialize() in the background.
+// ** @details IMU calibration, loading the joystick curves and setting up the auton selector each run in their own
+// task so initialize() returns straight away. Each job has a ready flag that can be checked or waited on.
+// ** @author Ansh Rao - 2145Z
+
+// Defining startup constants
+#define STARTUP_IMU_GRACE 300  // ms autonomous waits for the IMU before running the fallback
+
+// declaring startup job struct
+struct startup_job {
+    const char* name;
+    std::atomic<bool> ready{false};
+    bool ok = false;        // only valid once ready is set
+    uint32_t done_ms = 0;   // ms after startup_begin() the job finished
+
+    startup_job(const char* name) : name(name) {}
+
+    bool wait(uint32_t timeout_ms) const;
+};
+
+// declaring startup variables
+inline startup_job startup_imu("imu");
+inline startup_job startup_curve("curve");
+inline startup_job startup_selector("selector");
+inline uint32_t startup_begin_ms = 0;
+inline std::atomic<int> startup_remaining{0};
+inline pros::Mutex startup_sd_mutex;  // the curve and selector jobs both read the SD card
+
+// declaring startup functions
+void startup_begin(int jobs);
+void startup_run(startup_job& job, std::function<bool()> fn);
+void startup_report();
@@ -28,6 +28,8 @@
 #define PORT_ODOM_HORIZ 12
 #define PORT_ODOM_VERT 13
 #define PORT_OPTICAL 14
+#define PORT_GPS 15
+#define PORT_COLOR 16
 
 // Defining three wire ports
 
@@ -35,6 +37,7 @@
 #define DRIVE_DIAMETER 3.25
 #define DRIVE_RPM 450
 #define ODOM_DIAMETER 2.125
+#define DRIVE_WIDTH 12.0  // Distance between the left and right wheels in inches
 #define OFFSET_VERT 0
 #define OFFSET_HORI 0
 #define DRIVE_SPEED 110
@@ -78,6 +81,8 @@ inline pros::Link     vexnet     (PORT_VEXNET, "2145Z_link", pros::E_LINK_TX);
 inline pros::Rotation odom_horiz (PORT_ODOM_HORIZ);  // This is the horizontal tracking wheel
 inline pros::Rotation odom_vert  (PORT_ODOM_VERT);   // This is the vertical tracking wheel
 inline pros::Distance opticalSort(PORT_OPTICAL);  // This is the distance sensor
+inline pros::Gps      gps        (PORT_GPS);       // This is the GPS sensor, odometry uses it if it's plugged in
+inline pros::Optical  colorSort  (PORT_COLOR);     // This is the optical sensor that sorts blocks by colour
 
 // three wire port constructors
 
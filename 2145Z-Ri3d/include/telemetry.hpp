@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "EZ-Template/api.hpp"
+
+// ** @file telemetry.hpp
+// ** @brief This file contains the telemetry ring buffer and the function headers for recording PID internals.
+// ** @details The executive snapshots every chassis PID into a frame each tick and pushes it into a
+// single-producer/single-consumer ring. A low priority task drains the ring, so the control tick only ever
+// pays for the copy and never waits on the terminal.
+// ** @author Ansh Rao - 2145Z
+
+// Defining telemetry constants
+#define TELEMETRY_FRAMES 128  // ring size in frames, must be a power of two
+#define TELEMETRY_RATE 100    // frames per second recorded by the executive
+#define TELEMETRY_MOTORS 9    // LF, LM, LB, RF, RM, RB, intake, roller 1, roller 2
+#define TELEMETRY_MOTOR_RATE 10  // times per second the motors are read, frames in between repeat the last reading
+
+// @brief Single-producer/single-consumer lock-free ring buffer
+// @details push() must only be called from one task and pop() from one other task. Neither ever blocks,
+// push() drops the item and returns false when the ring is full.
+template <typename T, size_t N>
+struct spsc_ring {
+    static_assert((N & (N - 1)) == 0, "spsc_ring size must be a power of two");
+
+    T items[N];
+    std::atomic<uint32_t> head{0};  // next slot to write, only the producer stores this
+    std::atomic<uint32_t> tail{0};  // next slot to read, only the consumer stores this
+
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == N) {return false;}
+        items[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {return false;}
+        item = items[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+};
+
+// declaring telemetry PID indexes, in the order they are stored in a frame
+enum telemetry_pid { TLM_TURN = 0,
+                     TLM_DRIVE,
+                     TLM_HEADING,
+                     TLM_SWING,
+                     TLM_XY,
+                     TLM_ODOM_ANGULAR,
+                     TLM_BOOMERANG,
+                     TLM_PID_COUNT };
+
+// declaring telemetry structs
+struct pid_snapshot {
+    float target;
+    float cur;
+    float error;
+    float output;
+    float integral;
+    float derivative;
+};
+
+struct telemetry_frame {
+    uint64_t time;  // us since the program started
+    uint8_t mode;   // ez::e_mode the chassis was in
+    float x;        // odom pose in inches and degrees
+    float y;
+    float theta;
+    float left;     // raw sensors behind the pose, so it can be replayed: drive encoders in inches,
+    float right;
+    float vert;     // tracking wheels in inches,
+    float horiz;
+    float imu;      // and IMU rotation in degrees before drive_imu_scaler_set is applied
+    int16_t current[TELEMETRY_MOTORS];  // mA, at TELEMETRY_MOTOR_RATE
+    int16_t voltage[TELEMETRY_MOTORS];  // mV, at TELEMETRY_MOTOR_RATE
+    pid_snapshot pids[TLM_PID_COUNT];
+};
+
+// declaring telemetry variables
+inline spsc_ring<telemetry_frame, TELEMETRY_FRAMES> telemetry_ring;
+inline std::atomic<uint32_t> telemetry_dropped{0};
+inline bool telemetry_print = false;
+
+// declaring telemetry functions
+void telemetry_record();
+void telemetry_print_toggle(bool toggle);
+void telemetry_t();
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "trajectory_table.hpp"
+
+// ** @file trajectories.hpp
+// ** @brief This file holds trajectory tables generated off the robot.
+// ** @details Append tables with tools/gen_trajectory.cpp, for example:
+//   gen_trajectory s_curve 12.0 60 120 400 0,0,0 24,24,90 >> include/trajectories.hpp
+// and follow them with pid_trajectory_set(trajectory_table(traj_s_curve)). Tables are constexpr so they live in
+// flash and cost nothing to start.
+// ** @author Ansh Rao - 2145Z
+
+// Generated tables go below this line
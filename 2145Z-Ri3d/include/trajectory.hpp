@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "EZ-Template/api.hpp"
+#include "ff_fit.hpp"
+#include "ramsete.hpp"
+#include "trajectory_table.hpp"
+
+// ** @file trajectory.hpp
+// ** @brief This file contains the function headers for following time-parameterised trajectories.
+// ** @details The follower runs from the executive. Each tick it looks up where the trajectory says the robot should
+// be, drives the wheels with feedforward from the trajectory's velocity and acceleration, and corrects with odometry.
+// ** @author Ansh Rao - 2145Z
+
+// declaring trajectory controller enum
+// - TRAJ_LINEAR corrects with traj_k's fixed gains, TRAJ_RAMSETE with ramsete_k's, which get stronger with speed
+enum traj_controller {
+    TRAJ_LINEAR,
+    TRAJ_RAMSETE
+};
+
+// declaring trajectory constants struct
+struct traj_constants {
+    ff_gains left;     // drive_set output for the left side, per in/s and in/s^2 of wheel travel
+    ff_gains right;    // the same for the right side
+    ff_gains angular;  // (left - right) / 2 output per deg/s and deg/s^2 turning on the spot
+    double k_along;    // in/s added per inch behind the reference
+    double k_cross;    // deg/s added per inch the reference is off to the side
+    double k_theta;    // deg/s added per degree of heading error
+};
+
+// declaring trajectory variables
+// - kV starts at 127 / free speed (450 rpm on 3.25" wheels is ~76.6 in/s), kS and kA are rough guesses
+// - angular starts as the linear constants at DRIVE_WIDTH / 2, per degree
+// - default_constants() replaces the feedforward constants with what measure_feedforward() saved, if there are any
+inline traj_constants traj_k = {{4.0, 127.0 / 76.6, 0.15}, {4.0, 127.0 / 76.6, 0.15}, {4.0, 0.1736, 0.0157}, 2.0, 3.0, 2.0};
+inline ramsete_gains ramsete_k = {0.006, 0.7};  // b is firmer than the usual 0.0013, see tools/ramsete_sim.cpp
+inline trajectory traj_active;
+inline traj_controller traj_controller_active = TRAJ_RAMSETE;
+inline std::atomic<bool> traj_running{false};  // cleared before traj_active changes, set again once it has
+inline uint32_t traj_start_time = 0;
+inline size_t traj_index = 0;
+inline std::vector<std::vector<traj_point>> traj_generated;  // owns trajectories generated on the brain
+
+// declaring trajectory functions
+trajectory trajectory_generate(std::vector<ez::pose> waypoints, double max_vel, double max_accel, double max_jerk, bool reversed = false);
+void pid_trajectory_set(trajectory traj, traj_controller controller = TRAJ_RAMSETE);
+void trajectory_wait();
+void trajectory_stop();
+double trajectory_feedforward(const ff_gains& k, double vel, double accel);
+double trajectory_turn_radius();
+void trajectory_iterate();
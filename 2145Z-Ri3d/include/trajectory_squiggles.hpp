@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "squiggles.hpp"
+#include "trajectory_table.hpp"
+
+// ** @file trajectory_squiggles.hpp
+// ** @brief This file converts between squiggles and trajectory points.
+// ** @details Used by the robot when it generates a trajectory itself, and by tools/gen_trajectory.cpp.
+// squiggles measures yaw counterclockwise from +x in radians, EZ-Template measures theta clockwise from +y in degrees.
+// ** @author Ansh Rao - 2145Z
+
+// @brief Converts an EZ-Template style pose to a squiggles pose
+// @param x, y Position in inches
+// @param theta Heading in degrees, clockwise from +y
+inline squiggles::Pose trajectory_waypoint(double x, double y, double theta) {
+    return squiggles::Pose(x, y, (90.0 - theta) * M_PI / 180.0);
+}
+
+// @brief Converts a generated squiggles profile to trajectory points
+// @param profile The output of squiggles::SplineGenerator::generate()
+// @param reversed True if the robot drives the path backwards
+// @return One trajectory point per profile point
+inline std::vector<traj_point> trajectory_from_profile(const std::vector<squiggles::ProfilePoint>& profile, bool reversed = false) {
+    std::vector<traj_point> points;
+    points.reserve(profile.size());
+    double sign = reversed ? -1.0 : 1.0;
+    for (const squiggles::ProfilePoint& p : profile) {
+        traj_point point;
+        point.time = p.time;
+        point.x = p.vector.pose.x;
+        point.y = p.vector.pose.y;
+        point.theta = 90.0 - p.vector.pose.yaw * 180.0 / M_PI + (reversed ? 180.0 : 0.0);
+        point.vel = sign * p.vector.vel;
+        point.accel = sign * p.vector.accel;
+        point.omega = -p.curvature * p.vector.vel * 180.0 / M_PI;  // squiggles curvature is counterclockwise
+        points.push_back(point);
+    }
+    return points;
+}
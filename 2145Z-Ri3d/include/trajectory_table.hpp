@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+// ** @file trajectory_table.hpp
+// ** @brief This file contains the point format for time-parameterised trajectories.
+// ** @details tools/gen_trajectory.cpp emits tables of these that the robot compiles straight into flash, see
+// trajectories.hpp.
+// ** @author Ansh Rao - 2145Z
+
+// declaring trajectory point struct
+// Units and directions match EZ-Template odom: inches, degrees, theta 0 facing +y and positive clockwise
+struct traj_point {
+    float time;   // s since the start of the trajectory
+    float x;      // in
+    float y;      // in
+    float theta;  // deg
+    float vel;    // in/s along the path, negative when driving backwards
+    float accel;  // in/s^2
+    float omega;  // deg/s, positive clockwise
+};
+
+// declaring trajectory struct
+struct trajectory {
+    const traj_point* points = nullptr;
+    size_t size = 0;
+};
+
+// @brief Wraps a table of points as a trajectory
+template <size_t N>
+constexpr trajectory trajectory_table(const traj_point (&points)[N]) { return {points, N}; }
@@ -0,0 +1,50 @@
+#include "actuator.hpp"
+#include "main.h"
+
+// ** @file actuator.cpp
+// ** @brief This file contains the actuator writes.
+// ** @details actuator_set() only remembers the command, actuator_write() turns it into one motor call. Subsystems
+// call actuator_write() once at the end of their executive callback, so a tick that changes its mind a few times
+// still only talks to the motor once.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region actuator
+// @brief Sets what an actuator should do on its next write
+// @param act The actuator
+// @param command A millivolts, rpm or percent command
+void actuator_set(actuator& act, actuator_command command) { act.pending = command; }
+
+// @brief Gets the top speed of an actuator's motor from its gearset
+// @return The top speed in rpm
+double actuator_max_rpm(const actuator& act) {
+    switch (act.motor.get_gearing()) {
+        case pros::v5::MotorGears::red: return 100.0;
+        case pros::v5::MotorGears::blue: return 600.0;
+        default: return 200.0;
+    }
+}
+
+// @brief Writes an actuator's command to its motor
+// @param act The actuator
+// @details Voltages are scaled for the battery and go to the motor. Velocities go to move_velocity(), the motor's
+// own PID holds them. Percent is a velocity as a percent of the gearset's top speed.
+// @note The motor is only written to when what's sent changes
+void actuator_write(actuator& act) {
+    const actuator_command& command = act.pending;
+    actuator_mode mode = ACTUATOR_VOLTAGE;
+    double value = 0.0;
+
+    if (command.mode == ACTUATOR_VOLTAGE) {
+        value = std::round(battery_apply(battery_scale_get(), command.value, ACTUATOR_MAX_MV));  // Whole mV, so a steady command skips the write
+    } else {
+        mode = ACTUATOR_VELOCITY;
+        value = command.mode == ACTUATOR_PERCENT ? command.value / 100.0 * actuator_max_rpm(act) : command.value;
+    }
+
+    if (mode == act.written_mode && value == act.written) {return;}
+    if (mode == ACTUATOR_VOLTAGE) {act.motor.move_voltage(value);}
+    else {act.motor.move_velocity(value);}
+    act.written_mode = mode;
+    act.written = value;
+}
+#pragma endregion
@@ -7,6 +7,28 @@
  * @author Ansh Rao - 2145Z
  */
 
+#pragma region paths
+// Pure pursuit paths, these are generated once by paths_init() instead of at the start of each motion
+static const std::vector<ez::united_odom> pp_example_path = {{{6_in, 10_in}, fwd, DRIVE_SPEED},
+                                                              {{0_in, 20_in}, fwd, DRIVE_SPEED},
+                                                              {{0_in, 30_in}, fwd, DRIVE_SPEED}};
+static trajectory traj_example_fwd, traj_example_rev;
+static const std::vector<ez::united_odom> pp_wait_until_path = {{{0_in, 24_in}, fwd, DRIVE_SPEED},
+                                                               {{12_in, 24_in}, fwd, DRIVE_SPEED},
+                                                               {{24_in, 24_in}, fwd, DRIVE_SPEED}};
+
+// @brief Generates every pure pursuit path used by the autons
+// @note Call this after default_constants(), the path spacing and smoothing constants are part of each path
+void paths_init() {
+  path_cache_add(pp_example_path);
+  path_cache_add(pp_wait_until_path);
+
+  // Swap these for flash tables from tools/gen_trajectory.cpp to skip generating them here
+  traj_example_fwd = trajectory_generate({{0, 0, 0}, {24, 24, 90}}, 60, 120, 400);
+  traj_example_rev = trajectory_generate({{24, 24, 90}, {0, 0, 0}}, 60, 120, 400, true);
+}
+#pragma endregion
+
 #pragma region example_autos
 
 //
@@ -28,6 +50,16 @@ void drive_example() {
   chassis.pid_wait();
 }
 
+///
+// No IMU Fallback
+///
+void drive_no_imu() {
+  // autonomous() runs this instead of the selected auton if the IMU isn't calibrated in time
+  // The last parameter turns heading correction off, without the IMU it would steer towards garbage
+  chassis.pid_drive_set(24_in, DRIVE_SPEED, true, false);
+  chassis.pid_wait();
+}
+
 ///
 // Turn Example
 ///
@@ -74,7 +106,7 @@ void wait_until_change_speed() {
   // When the robot gets to 6 inches slowly, the robot will travel the remaining distance at full speed
   chassis.pid_drive_set(24_in, 30, true);
   chassis.pid_wait_until(6_in);
-  chassis.pid_speed_max_set(DRIVE_SPEED);  // After driving 6 inches at 30 speed, the robot will go the remaining distance at DRIVE_SPEED
+  battery_speed_max_set(DRIVE_SPEED);  // After driving 6 inches at 30 speed, the robot will go the remaining distance at DRIVE_SPEED
   chassis.pid_wait();
 
   chassis.pid_turn_set(45_deg, TURN_SPEED);
@@ -89,7 +121,7 @@ void wait_until_change_speed() {
   // When the robot gets to -6 inches slowly, the robot will travel the remaining distance at full speed
   chassis.pid_drive_set(-24_in, 30, true);
   chassis.pid_wait_until(-6_in);
-  chassis.pid_speed_max_set(DRIVE_SPEED);  // After driving 6 inches at 30 speed, the robot will go the remaining distance at DRIVE_SPEED
+  battery_speed_max_set(DRIVE_SPEED);  // After driving 6 inches at 30 speed, the robot will go the remaining distance at DRIVE_SPEED
   chassis.pid_wait();
 }
 
@@ -171,7 +203,7 @@ void tug(int attempts) {
 
     // If failsafed...
     if (chassis.interfered) {
-      chassis.drive_sensor_reset();
+      odom_sensor_reset();
       chassis.pid_drive_set(-2_in, 20);
       pros::delay(1000);
     }
@@ -219,12 +251,9 @@ void odom_drive_example() {
 // Odom Pure Pursuit
 ///
 void odom_pure_pursuit_example() {
-  // Drive to 0, 30 and pass through 6, 10 and 0, 20 on the way, with slew
-  chassis.pid_odom_set({{{6_in, 10_in}, fwd, DRIVE_SPEED},
-                        {{0_in, 20_in}, fwd, DRIVE_SPEED},
-                        {{0_in, 30_in}, fwd, DRIVE_SPEED}},
-                       true);
-  chassis.pid_wait();
+  // Drive to 0, 30 and pass through 6, 10 and 0, 20 on the way
+  pid_pursuit_set(pp_example_path);
+  pursuit_wait();
 
   // Drive to 0, 0 backwards
   chassis.pid_odom_set({{0_in, 0_in}, rev, DRIVE_SPEED},
@@ -236,13 +265,10 @@ void odom_pure_pursuit_example() {
 // Odom Pure Pursuit Wait Until
 ///
 void odom_pure_pursuit_wait_until_example() {
-  chassis.pid_odom_set({{{0_in, 24_in}, fwd, DRIVE_SPEED},
-                        {{12_in, 24_in}, fwd, DRIVE_SPEED},
-                        {{24_in, 24_in}, fwd, DRIVE_SPEED}},
-                       true);
-  chassis.pid_wait_until_index(1);  // Waits until the robot passes 12, 24
+  pid_pursuit_set(pp_wait_until_path);
+  pursuit_wait_until_point({12_in, 24_in});  // Waits until the robot passes 12, 24
   // Intake.move(127);  // Set your intake to start moving once it passes through the second point in the index
-  chassis.pid_wait();
+  pursuit_wait();
   // Intake.move(0);  // Turn the intake off
 }
 
@@ -274,6 +300,37 @@ void odom_boomerang_injected_pure_pursuit_example() {
   chassis.pid_wait();
 }
 
+///
+// Trajectory following
+///
+void odom_trajectory_example() {
+  // This follows a time-parameterised path generated by squiggles, the robot is told
+  // how fast to be going at every point so it doesn't have to slow down for PID to settle
+  // RAMSETE pulls it back onto the path, pass TRAJ_LINEAR as well to use traj_k's fixed gains instead
+  pid_trajectory_set(traj_example_fwd);
+  trajectory_wait();
+
+  pid_trajectory_set(traj_example_rev);
+  trajectory_wait();
+}
+
+///
+// Motion profiled drive example
+///
+void profile_drive_example() {
+  // This is drive_example with motion profiles, the robot follows a smooth velocity curve
+  // instead of saturating PID, and EZ-Template's PID only settles the last bit
+  pid_profile_drive_set(24_in);
+  profile_wait();
+
+  chassis.pid_turn_set(45_deg, TURN_SPEED);
+  chassis.pid_wait_quick_chain();
+
+  pid_profile_drive_set(-24_in);
+  profile_wait_until(-12_in);  // Anything here runs once the robot is halfway back
+  profile_wait();
+}
+
 ///
 // Calculate the offsets of your tracking wheels
 ///
@@ -293,10 +350,8 @@ void measure_offsets() {
   for (int i = 0; i < iterations; i++) {
     // Reset pid targets and get ready for running an auton
     chassis.pid_targets_reset();
-    chassis.drive_imu_reset();
-    chassis.drive_sensor_reset();
+    odom_fast_reset(0, 0, 0);  // Our odom task and EZ-Template's both start the run from 0, 0, 0
     chassis.drive_brake_set(MOTOR_BRAKE_HOLD);
-    chassis.odom_xyt_set(0_in, 0_in, 0_deg);
     double imu_start = chassis.odom_theta_get();
     double target = i % 2 == 0 ? 90 : 270;  // Switch the turn target every run from 270 to 90
 
@@ -334,4 +389,50 @@ void measure_offsets() {
   if (chassis.odom_tracker_front != nullptr) chassis.odom_tracker_front->distance_to_center_set(f_offset);
 }
 
+///
+// Measure the feedforward constants of your drive
+///
+void measure_feedforward() {
+  // Each side and turning get their own fit
+  ff_fit left, right, angular;
+
+  // Take the drive away from EZ-Template's PID, the tests write to the motors themselves
+  trajectory_stop();
+  profile_running = false;
+  pursuit_stop();
+  chassis.pid_targets_reset();
+  odom_fast_reset(0, 0, 0);  // Not drive_sensor_reset(), the odom task would see the jump as motion
+  chassis.drive_brake_set(MOTOR_BRAKE_BRAKE);
+  chassis.drive_mode_set(ez::DISABLE);
+
+  // A slow ramp and a step each way, driving straight and then turning on the spot
+  // - the ramps mostly measure kS and kV, the steps mostly kA
+  for (double direction : {1.0, -1.0}) {
+    ff_test(left, right, angular, false, 0.0, FF_RAMP_RATE * direction, FF_RAMP_TIME);
+    ff_test(left, right, angular, false, FF_STEP_OUTPUT * direction, 0.0, FF_STEP_TIME);
+    ff_test(left, right, angular, true, 0.0, FF_RAMP_RATE * direction, FF_RAMP_TIME);
+    ff_test(left, right, angular, true, FF_STEP_OUTPUT * direction, 0.0, FF_STEP_TIME);
+  }
+  // Stay in DISABLE, the targets were reset at the start and the robot has moved since, so the next motion sets the mode
+
+  // Fit them, and only keep them if every one explains the tests
+  ff_gains left_k, right_k, angular_k;
+  double left_r2 = 0.0, right_r2 = 0.0, angular_r2 = 0.0;
+  bool solved = ff_fit_solve(left, left_k, left_r2) && ff_fit_solve(right, right_k, right_r2) && ff_fit_solve(angular, angular_k, angular_r2);
+  printf("ff: r2 left %.3f, right %.3f, angular %.3f\n", left_r2, right_r2, angular_r2);
+  if (!solved || left_r2 < FF_MIN_R2 || right_r2 < FF_MIN_R2 || angular_r2 < FF_MIN_R2) {
+    printf("ff: the fit didn't hold up, keeping the old constants\n");
+    master.rumble("---");
+    return;
+  }
+
+  // Use them now and from the next time the program starts
+  traj_k.left = left_k;
+  traj_k.right = right_k;
+  traj_k.angular = angular_k;
+  ff_save();
+  ff_print();
+  master.rumble(".");
+}
+
 #pragma endregion
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "battery.hpp"
+#include "main.h"
+
+// ** @file battery.cpp
+// ** @brief This file contains the battery voltage compensation.
+// ** @details See battery_comp.hpp for the filter and why outputs are scaled to a nominal voltage.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region gains
+// @brief Keeps the PID gains EZ-Template has now as the ones to scale from
+static void battery_capture() {
+    battery_base.drive_forward = chassis.pid_drive_constants_forward_get();
+    battery_base.drive_backward = chassis.pid_drive_constants_backward_get();
+    battery_base.heading = chassis.pid_heading_constants_get();
+    battery_base.turn = chassis.pid_turn_constants_get();
+    battery_base.swing_forward = chassis.pid_swing_constants_forward_get();
+    battery_base.swing_backward = chassis.pid_swing_constants_backward_get();
+}
+
+// @brief Sets EZ-Template's PID gains to the captured ones times a scale
+// @details Scaling kP, kI and kD scales the PID's output, start_i is an error so it stays as it is
+static void battery_gains_set(double scale) {
+    const battery_gains& b = battery_base;
+    chassis.pid_drive_constants_forward_set(b.drive_forward.kp * scale, b.drive_forward.ki * scale, b.drive_forward.kd * scale,
+                                            b.drive_forward.start_i);
+    chassis.pid_drive_constants_backward_set(b.drive_backward.kp * scale, b.drive_backward.ki * scale, b.drive_backward.kd * scale,
+                                             b.drive_backward.start_i);
+    chassis.pid_heading_constants_set(b.heading.kp * scale, b.heading.ki * scale, b.heading.kd * scale, b.heading.start_i);
+    chassis.pid_turn_constants_set(b.turn.kp * scale, b.turn.ki * scale, b.turn.kd * scale, b.turn.start_i);
+    chassis.pid_swing_constants_forward_set(b.swing_forward.kp * scale, b.swing_forward.ki * scale, b.swing_forward.kd * scale,
+                                            b.swing_forward.start_i);
+    chassis.pid_swing_constants_backward_set(b.swing_backward.kp * scale, b.swing_backward.ki * scale, b.swing_backward.kd * scale,
+                                             b.swing_backward.start_i);
+    battery_applied = scale;
+}
+
+// @brief Reads the parts of EZ-Template's state a motion setter changes
+// @return The drive mode and the targets of the PIDs its drive, turn and swing motions use
+static battery_motion battery_motion_get() {
+    return {chassis.drive_mode_get(), chassis.leftPID.target, chassis.rightPID.target, chassis.turnPID.target,
+            chassis.swingPID.target};
+}
+
+// @brief Scales a max speed for the battery
+static int battery_speed_scaled(int speed, double scale) {
+    return (int)ez::util::clamp(std::round(speed * scale), 127.0, 0.0);
+}
+
+// @brief Scales the current motion's max speed
+// @details EZ-Template's setters write the max speed they're given, so when a motion starts the max speed is what it
+// asked for. That's kept, and every iteration after sets the max speed to it times the scale.
+static void battery_speed_apply(double scale) {
+    battery_motion motion = battery_motion_get();
+    if (battery_motion_pending.exchange(false) || !(motion == battery_motion_last)) {
+        battery_motion_last = motion;
+        battery_speed_requested = chassis.pid_speed_max_get();
+    }
+    int speed = battery_speed_scaled(battery_speed_requested, scale);
+    if (speed != chassis.pid_speed_max_get()) {chassis.pid_speed_max_set(speed);}
+}
+#pragma endregion
+
+#pragma region battery
+// @brief Takes the PID gains to scale from
+// @note Call this in initialize() after default_constants()
+void battery_start() {
+    battery_capture();
+    battery_applied = 1.0;
+}
+
+// @brief Gets what our own outputs should be multiplied by
+// @return The battery scale, 1 when compensation is off
+double battery_scale_get() {
+    return battery_comp_enabled ? battery_scale(battery_state) : 1.0;
+}
+
+// @brief Marks that a motion has just started
+// @details Call this after an EZ-Template odom motion that follows another in the same mode. Odom targets aren't
+// public, so that's the one start battery_iterate() can't see on its own.
+void battery_motion_start() {
+    battery_motion_pending = true;
+}
+
+// @brief Changes the current motion's max speed, use this instead of chassis.pid_speed_max_set()
+// @param speed The max speed, 0 to 127
+void battery_speed_max_set(int speed) {
+    battery_speed_requested = speed;
+    chassis.pid_speed_max_set(battery_speed_scaled(speed, battery_scale_get()));
+}
+
+// @brief Runs one iteration of battery compensation
+// @details While the PID tuner is open its gains are left alone and taken as the new ones to scale from, so
+// tuning happens on unscaled gains.
+// @note This is registered with the executive in initialize()
+void battery_iterate() {
+    int32_t voltage = pros::battery::get_voltage();
+    if (voltage != PROS_ERR && voltage > 0) {battery_filter(battery_state, voltage, 1.0 / BATTERY_RATE);}
+
+    if (chassis.pid_tuner_enabled()) {
+        if (battery_applied != 1.0) {battery_gains_set(1.0);}
+        battery_capture();
+        return;
+    }
+    double scale = battery_scale_get();
+    if (fabs(scale - battery_applied) >= BATTERY_APPLY_STEP) {battery_gains_set(scale);}
+    battery_speed_apply(scale);
+}
+
+// @brief Prints the battery voltage and the scale to the terminal
+void battery_print() {
+    printf("battery: %.2fV filtered, scale %.3f%s\n", battery_state.filtered / 1000.0, battery_scale(battery_state),
+           battery_comp_enabled ? "" : " (compensation off)");
+}
+#pragma endregion
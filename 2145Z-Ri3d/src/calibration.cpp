@@ -0,0 +1,145 @@
+#include "calibration.hpp"
+#include "main.h"
+
+// ** @file calibration.cpp
+// ** @brief This file contains the online tracking wheel offset and IMU scaler calibration.
+// ** @details Samples come from the odom task. Loading and saving only happen outside of it, in odom_start() and
+// disabled(), so the SD card never holds up odometry.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region persistence
+// @brief Loads saved estimates from the SD card
+// @details Saved estimates come with their sample counts and variances, so they're used straight away and new
+// samples carry on from them instead of replacing them. Files from before the variances were saved only give the
+// estimates a starting point, their sample counts are dropped so they're learned again.
+// @note The SD card is shared with the other startup jobs and the flight recorder, so startup_sd_mutex is held.
+void calib_load() {
+    if (!pros::usd::is_installed()) {return;}
+    startup_sd_mutex.take();
+    FILE* file = fopen(CALIB_FILE, "r");
+    char line[160] = "";
+    bool read = file != nullptr && fgets(line, sizeof(line), file) != nullptr;
+    if (file != nullptr) {fclose(file);}
+    startup_sd_mutex.give();
+    if (!read) {return;}
+
+    double vert, horiz, imu, vert_P, horiz_P, imu_P;
+    unsigned long vert_n, horiz_n, imu_n;
+    int count = sscanf(line, "%lf %lu %lf %lf %lu %lf %lf %lu %lf", &vert, &vert_n, &vert_P, &horiz, &horiz_n, &horiz_P, &imu, &imu_n, &imu_P);
+    if (count == 9) {
+        calib_vert.P = vert_P;
+        calib_horiz.P = horiz_P;
+        calib_imu.P = imu_P;
+    } else if (sscanf(line, "%lf %lu %lf %lu %lf %lu", &vert, &vert_n, &horiz, &horiz_n, &imu, &imu_n) == 6) {
+        vert_n = horiz_n = imu_n = 0;
+    } else {
+        return;
+    }
+    calib_vert.estimate = vert;
+    calib_vert.samples = vert_n;
+    calib_horiz.estimate = horiz;
+    calib_horiz.samples = horiz_n;
+    calib_imu.estimate = imu;
+    calib_imu.samples = imu_n;
+    if (calib_imu.samples >= CALIB_MIN_SAMPLES) {chassis.drive_imu_scaler_set(calib_imu.estimate);}
+    printf("calib: loaded from %s\n", CALIB_FILE);
+    calib_print();
+}
+
+// @brief Saves the estimates to the SD card
+// @details Only estimates with enough samples are kept, the rest save whatever was loaded or the defaults.
+// Each estimate is saved with its sample count and variance.
+// @note The flight recorder may still be writing, so startup_sd_mutex is held.
+void calib_save() {
+    if (!pros::usd::is_installed()) {return;}
+    double scaler = calib_imu.samples >= CALIB_MIN_SAMPLES ? calib_imu.estimate : chassis.drive_imu_scaler_get();
+    startup_sd_mutex.take();
+    FILE* file = fopen(CALIB_FILE, "w");
+    if (file != nullptr) {
+        fprintf(file, "%.4f %lu %.6g %.4f %lu %.6g %.5f %lu %.6g\n", calib_vert_offset(), (unsigned long)calib_vert.samples, calib_vert.P,
+                calib_horiz_offset(), (unsigned long)calib_horiz.samples, calib_horiz.P, scaler, (unsigned long)calib_imu.samples, calib_imu.P);
+        fclose(file);
+    }
+    startup_sd_mutex.give();
+}
+
+// @brief Prints the estimates to the terminal
+void calib_print() {
+    printf("calib: vert offset %.3f (%lu samples), horiz offset %.3f (%lu samples), imu scaler %.5f in use, %.5f estimated (%lu samples)\n",
+           calib_vert_offset(), (unsigned long)calib_vert.samples, calib_horiz_offset(), (unsigned long)calib_horiz.samples,
+           chassis.drive_imu_scaler_get(), calib_imu.estimate, (unsigned long)calib_imu.samples);
+}
+#pragma endregion
+
+#pragma region estimates
+// @brief Gets the parallel tracker's offset odometry should use
+// @return The estimate once it has enough samples, OFFSET_VERT until then
+double calib_vert_offset() {
+    return calib_vert.samples >= CALIB_MIN_SAMPLES ? calib_vert.estimate : OFFSET_VERT;
+}
+
+// @brief Gets the perpendicular tracker's offset odometry should use
+// @return The estimate once it has enough samples, OFFSET_HORI until then
+double calib_horiz_offset() {
+    return calib_horiz.samples >= CALIB_MIN_SAMPLES ? calib_horiz.estimate : OFFSET_HORI;
+}
+
+// @brief Adds one odom update to the offset estimators
+// @param d_vert The change in the parallel tracker in inches
+// @param d_horiz The change in the perpendicular tracker in inches
+// @param d_ime The change in the average of the drive encoders in inches
+// @param d_theta The change in the IMU's heading in degrees
+// @details Updates are summed into windows of CALIB_WINDOW, so one window turns enough to stand out from the
+// noise. Windows that barely turn are skipped, and once an estimate has settled, windows that miss it by more
+// than CALIB_GATE are wheel slip and are skipped too.
+void calib_sample(double d_vert, double d_horiz, double d_ime, double d_theta) {
+    if (!calib_enabled) {return;}
+    calib_current.vert += d_vert;
+    calib_current.horiz += d_horiz;
+    calib_current.ime += d_ime;
+    calib_current.theta += d_theta;
+    if (++calib_current.count < CALIB_WINDOW) {return;}
+
+    calib_window window = calib_current;
+    calib_current = calib_window();
+    if (fabs(window.theta) < CALIB_MIN_TURN) {return;}
+
+    double angle = ez::util::to_rad(window.theta);
+    rls1_update(calib_vert, angle, window.vert - window.ime, calib_vert.samples >= CALIB_MIN_SAMPLES ? CALIB_GATE : 0.0);
+    rls1_update(calib_horiz, angle, window.horiz, calib_horiz.samples >= CALIB_MIN_SAMPLES ? CALIB_GATE : 0.0);
+}
+
+// @brief Throws away the window and GPS fix in progress
+// @details The odom task calls this when the pose is set, the sensors have usually just been reset too.
+void calib_restart() {
+    calib_current = calib_window();
+    calib_gps_anchored = false;
+}
+
+// @brief Adds one GPS fix to the IMU scaler estimator
+// @param gps_heading The GPS's heading in degrees
+// @param imu_rotation The IMU's raw, unscaled rotation in degrees
+// @details The first fix is kept, and once the IMU has turned CALIB_MIN_GPS_TURN past it the two turns are
+// compared. The GPS heading wraps, so its turn is taken as whatever is closest to the IMU's turn times the estimate.
+// @note The new scaler is only saved, not applied, changing it mid-run would make every heading jump. It's used
+// from the next time the program starts.
+void calib_gps_sample(double gps_heading, double imu_rotation) {
+    static double anchor_gps = 0.0, anchor_imu = 0.0;
+    if (!calib_enabled) {return;}
+    if (!calib_gps_anchored) {
+        anchor_gps = gps_heading;
+        anchor_imu = imu_rotation;
+        calib_gps_anchored = true;
+        return;
+    }
+
+    double imu_turn = imu_rotation - anchor_imu;
+    if (fabs(imu_turn) < CALIB_MIN_GPS_TURN) {return;}
+    double expected = imu_turn * calib_imu.estimate;
+    double gps_turn = expected + remainder(gps_heading - anchor_gps - expected, 360.0);
+    anchor_gps = gps_heading;
+    anchor_imu = imu_rotation;
+
+    rls1_update(calib_imu, imu_turn, gps_turn, calib_imu.samples >= CALIB_MIN_SAMPLES ? CALIB_GPS_GATE : 0.0);
+}
+#pragma endregion
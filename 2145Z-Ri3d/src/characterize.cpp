@@ -0,0 +1,96 @@
+#include "characterize.hpp"
+#include "main.h"
+
+// ** @file characterize.cpp
+// ** @brief This file contains the feedforward tests and saving the constants they find.
+// ** @details The tests drive the chassis with drive_set() in DISABLE, the same way the followers do, so the
+// constants come out in the units the followers use. tools/ff_sim.cpp runs the same tests on a simulated drive.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region tests
+// @brief Runs one test and adds it to the fits
+// @param left Fit for the left side, straight tests only
+// @param right Fit for the right side, straight tests only
+// @param angular Fit for turning, turn tests only
+// @param turn True to turn on the spot, false to drive straight
+// @param start drive_set output at the start of the test
+// @param rate Output per second to ramp by, 0 for a step
+// @param time s to run for
+// @details Outputs are recorded as what they'd be at BATTERY_NOMINAL. The robot is stopped and given FF_REST to
+// settle afterwards.
+// @note The chassis has to be in DISABLE, otherwise EZ-Template's PID task writes over the outputs
+void ff_test(ff_fit& left, ff_fit& right, ff_fit& angular, bool turn, double start, double rate, double time) {
+    const int ticks = time * 1000 / ez::util::DELAY_TIME;
+    const double dt = ez::util::DELAY_TIME / 1000.0;
+    std::vector<double> left_pos, right_pos, heading, output;
+    left_pos.reserve(ticks);
+    right_pos.reserve(ticks);
+    heading.reserve(ticks);
+    output.reserve(ticks);
+
+    uint32_t now = pros::millis();
+    for (int tick = 0; tick < ticks; tick++) {
+        double out = ez::util::clamp(start + rate * tick * dt, 127.0);
+        left_pos.push_back(chassis.drive_sensor_left());
+        right_pos.push_back(chassis.drive_sensor_right());
+        heading.push_back(chassis.drive_imu_get());
+        output.push_back(std::round(out) * battery_state.filtered / BATTERY_NOMINAL);  // drive_set() only takes whole outputs
+        chassis.drive_set(std::round(out), std::round(turn ? -out : out));
+        pros::Task::delay_until(&now, ez::util::DELAY_TIME);
+    }
+    chassis.drive_set(0, 0);
+    pros::delay(FF_REST);
+
+    if (turn) {ff_fit_series(angular, heading, output, dt, FF_SPAN);}
+    else {
+        ff_fit_series(left, left_pos, output, dt, FF_SPAN);
+        ff_fit_series(right, right_pos, output, dt, FF_SPAN);
+    }
+}
+#pragma endregion
+
+#pragma region persistence
+// @brief Loads saved constants from the SD card into traj_k
+// @return True if constants were loaded, traj_k is left alone otherwise
+// @note default_constants() calls this. The SD card is shared with the startup jobs and the flight recorder, so
+// startup_sd_mutex is held.
+bool ff_load() {
+    if (!pros::usd::is_installed()) {return false;}
+    startup_sd_mutex.take();
+    FILE* file = fopen(FF_FILE, "r");
+    ff_gains left, right, angular;
+    bool loaded = file != nullptr && fscanf(file, "%lf %lf %lf %lf %lf %lf %lf %lf %lf", &left.kS, &left.kV, &left.kA, &right.kS,
+                                            &right.kV, &right.kA, &angular.kS, &angular.kV, &angular.kA) == 9;
+    if (file != nullptr) {fclose(file);}
+    startup_sd_mutex.give();
+    if (!loaded) {return false;}
+
+    traj_k.left = left;
+    traj_k.right = right;
+    traj_k.angular = angular;
+    printf("ff: loaded from %s\n", FF_FILE);
+    ff_print();
+    return true;
+}
+
+// @brief Saves traj_k's feedforward constants to the SD card
+// @note This runs during autonomous while the flight recorder may be writing, so startup_sd_mutex is held.
+void ff_save() {
+    if (!pros::usd::is_installed()) {return;}
+    startup_sd_mutex.take();
+    FILE* file = fopen(FF_FILE, "w");
+    if (file != nullptr) {
+        fprintf(file, "%.4f %.5f %.5f %.4f %.5f %.5f %.4f %.5f %.5f\n", traj_k.left.kS, traj_k.left.kV, traj_k.left.kA,
+                traj_k.right.kS, traj_k.right.kV, traj_k.right.kA, traj_k.angular.kS, traj_k.angular.kV, traj_k.angular.kA);
+        fclose(file);
+    }
+    startup_sd_mutex.give();
+}
+
+// @brief Prints the feedforward constants in use to the terminal
+void ff_print() {
+    printf("ff: left kS %.3f kV %.4f kA %.4f, right kS %.3f kV %.4f kA %.4f, angular kS %.3f kV %.5f kA %.5f\n", traj_k.left.kS,
+           traj_k.left.kV, traj_k.left.kA, traj_k.right.kS, traj_k.right.kV, traj_k.right.kA, traj_k.angular.kS, traj_k.angular.kV,
+           traj_k.angular.kA);
+}
+#pragma endregion
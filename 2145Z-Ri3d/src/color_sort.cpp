@@ -0,0 +1,49 @@
+#include "color_sort.hpp"
+#include "main.h"
+
+// ** @file color_sort.cpp
+// ** @brief This file contains the colour sort subsystem.
+// ** @details sort_iterate() feeds the optical sensor and roller encoder into sort_pipeline.hpp, and
+// rollers_iterate() reverses roller2 while it says to eject.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region sort
+// @brief Sets up the optical sensor and roller encoder for sorting
+void sort_init() {
+    colorSort.set_integration_time(SORT_INTEGRATION_TIME);
+    colorSort.set_led_pwm(SORT_LED);
+    motor_roller1.set_encoder_units(pros::E_MOTOR_ENCODER_DEGREES);
+}
+
+// @brief Runs one iteration of the colour sort
+// @note This is registered with the executive in initialize()
+void sort_iterate() {
+    // Blocks queued while the sort was off, or before the rollers ran backwards and pushed them back out, are no
+    // longer where their exit positions say they are
+    if (!sort_enabled || rollers_throughput.value < 0.0) {
+        sort_clear(sorter);
+        return;
+    }
+    sorter.eject_color = isRed ? BLOCK_BLUE : BLOCK_RED;
+
+    double hue = colorSort.get_hue();
+    int32_t proximity = colorSort.get_proximity();
+    double position = motor_roller1.get_position();
+    if (hue == PROS_ERR_F || proximity == PROS_ERR || position == PROS_ERR_F) {return;}
+    sort_update(sorter, pros::micros(), position, hue, proximity);
+}
+
+// @brief Checks if roller2 should be ejecting
+bool sort_ejecting() {
+    return sort_enabled && sorter.ejecting;
+}
+
+// @brief Prints how many blocks have been sorted and how long it took to the terminal
+void sort_print() {
+    const sort_stats& stats = sorter.stats;
+    double mean = stats.ejected > 0 ? (double)stats.latency_total / stats.ejected / 1000.0 : 0.0;
+    printf("sort: %lu detected, %lu ejected, %lu dropped, detect to eject %.1fms avg %.1fms worst, up to %.0f deg late\n",
+           (unsigned long)stats.detected, (unsigned long)stats.ejected, (unsigned long)stats.dropped, mean, stats.latency_worst / 1000.0,
+           stats.late_worst);
+}
+#pragma endregion
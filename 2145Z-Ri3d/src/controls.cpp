@@ -55,60 +55,115 @@ void default_constants() {
     chassis.odom_boomerang_dlead_set(0.625);     // This handles how aggressive the end of boomerang motions are
   
     chassis.pid_angle_behavior_set(ez::shortest);  // Changes the default behavior for turning, this defaults it to the shortest path there
+
+    // Feedforward constants measure_feedforward() saved, traj_k keeps its defaults if there aren't any
+    ff_load();
 }
 #pragma endregion
 
 #pragma region intake
-// @brief Sets the intake voltage
-// @param vltg The voltage to set the intake to
-// @details This function sets the voltage of the intake motor to the specified value.
-void set_intake(int vltg) { intake_vltg = vltg; }
+// @brief Sets the intake command
+// @param command A millivolts, rpm or percent command for the intake
+// @details This function sets what the intake should do, intake_iterate() writes it to the motor.
+void set_intake(actuator_command command) { intake_command = command; }
 
 // @brief Controls the intake based on button presses
-// @details This function checks if the intake button is pressed and sets the intake motor to the max voltage.
-// If the outtake button is pressed, it sets the intake motor to the negative max voltage. If neither button is pressed, it sets the intake motor to 0.
+// @details This function checks if the intake button is held and runs the intake at full speed.
+// If the outtake button is held, it runs the intake backwards at full speed. If neither button is held, it stops the intake.
 // @note This function is called in a loop to continuously check for button presses and control the intake motor accordingly.
 void control_intake() {
     if (isAuto) {return;}
-    else if (controlla.get_digital_new_press(BUTTON_INTAKE)) {set_intake(12000);}   
-    else if (controlla.get_digital_new_press(BUTTON_OUTTAKE)) {set_intake(-12000);}
-    else {set_intake(0);}
+    else if (controlla.get_digital(BUTTON_INTAKE)) {set_intake(percent(100));}
+    else if (controlla.get_digital(BUTTON_OUTTAKE)) {set_intake(percent(-100));}
+    else {set_intake(millivolts(0));}
 }
 
-void intake_t() {
-    pros::delay(100);
-    while (true) {
-        control_intake();
-        motor_intake.move_velocity(intake_vltg);
-        pros::delay(ez::util::DELAY_TIME);
+// @brief Runs one iteration of the intake
+// @details intake_command is what the driver or auton wants, the jam state machine decides when it's overridden.
+// @note This is registered with the executive in initialize()
+void intake_iterate() {
+    control_intake();
+    int32_t current = motor_intake.get_current_draw();
+    double velocity = motor_intake.get_actual_velocity();
+    double temperature = motor_intake.get_temperature();
+    if (current == PROS_ERR || velocity == PROS_ERR_F || temperature == PROS_ERR_F) {
+        current = 0;  // Without readings nothing looks like a jam, so the intake just runs
+        velocity = 0.0;
+        temperature = 0.0;
+    }
+
+    // The state machine only needs to know which way the intake is meant to go
+    intake_update(intake, pros::millis(), intake_command.direction() * ACTUATOR_MAX_MV, current, velocity, temperature);
+    switch (intake.state) {
+        case INTAKE_JAMMED: actuator_set(actuator_intake, millivolts(0)); break;
+        case INTAKE_REVERSING: actuator_set(actuator_intake, millivolts(intake.settings.reverse_voltage)); break;
+        default: actuator_set(actuator_intake, intake_command); break;
     }
+    actuator_write(actuator_intake);
+}
+
+// @brief Prints how many times the intake has jammed to the terminal
+void intake_print() {
+    printf("intake: %lu jams, %lu lockouts, %s\n", (unsigned long)intake.stats.jams, (unsigned long)intake.stats.lockouts,
+           intake.locked ? "locked out until released" : "running");
 }
 #pragma endregion
 
 #pragma region rollers
-// @brief Sets the rollers voltage
-// @param vltg The voltage to set the rollers to
-// @details This function sets the voltage of the rollers motor to the specified value.
-void set_rollers(int vltg) { rollers_vltg = vltg; }
+// @brief Sets the rollers throughput
+// @param throughput How many blocks per second the rollers should move, negative runs them backwards
+// @details This function sets how fast the rollers should run, rollers_iterate() works out the voltages.
+void set_rollers(blocks_per_second throughput) { rollers_throughput = throughput; }
 
 // @brief Controls the rollers based on button presses
-// @details This function checks if the rollers button is pressed and sets the rollers motor to the max voltage.
-// If the outrollers button is pressed, it sets the rollers motor to the negative max voltage. If neither button is pressed, it sets the rollers motor to 0.
+// @details This function checks if the rollers button is held and runs the rollers at ROLLERS_DRIVER_BPS.
+// If the outrollers button is held, it runs the rollers backwards. If neither button is held, it stops the rollers.
 // @note This function is called in a loop to continuously check for button presses and control the rollers motor accordingly.
 void control_rollers() {
     if (isAuto) {return;}
-    else if (controlla.get_digital_new_press(BUTTON_ROLLERS)) {set_rollers(12000);}   
-    else if (controlla.get_digital_new_press(BUTTON_OUTROLLERS)) {set_rollers(-12000);}
-    else {set_rollers(0);}
+    else if (controlla.get_digital(BUTTON_ROLLERS)) {set_rollers(blocks_per_second(ROLLERS_DRIVER_BPS));}
+    else if (controlla.get_digital(BUTTON_OUTROLLERS)) {set_rollers(blocks_per_second(-ROLLERS_DRIVER_BPS));}
+    else {set_rollers(blocks_per_second(0.0));}
+}
+
+// @brief Sets up the roller encoders for the roller group
+void rollers_init() {
+    motor_roller1.set_encoder_units(pros::E_MOTOR_ENCODER_DEGREES);
+    motor_roller2.set_encoder_units(pros::E_MOTOR_ENCODER_DEGREES);
 }
 
-void rollers_t() {
-    pros::delay(100);
-    while (true) {
-        control_rollers();
-        motor_roller1.move_voltage(rollers_vltg);
-        motor_roller2.move_voltage(rollers_vltg);
-        pros::delay(ez::util::DELAY_TIME);
+// @brief Runs one iteration of the rollers
+// @details Both rollers are driven by the roller group. While the colour sort ejects, roller2 runs backwards on its
+// own and roller1 just holds its speed, then the group syncs them again from where they ended up.
+// @note This is registered with the executive in initialize()
+void rollers_iterate() {
+    control_rollers();
+    bool ejecting = sort_ejecting();
+    if (ejecting) {roller_resync(rollers);}
+
+    double first_position = motor_roller1.get_position();
+    double first_velocity = motor_roller1.get_actual_velocity();
+    double second_position = motor_roller2.get_position();
+    double second_velocity = motor_roller2.get_actual_velocity();
+    double target = roller_rpm(rollers, rollers_throughput);
+    if (first_position == PROS_ERR_F || first_velocity == PROS_ERR_F || second_position == PROS_ERR_F || second_velocity == PROS_ERR_F) {
+        roller_resync(rollers);  // Feedforward only until both motors answer again
+        first_position = second_position = 0.0;
+        first_velocity = second_velocity = target;
     }
+    roller_output output = roller_update(rollers, target, first_position, first_velocity, second_position, second_velocity);
+
+    actuator_set(actuator_roller1, millivolts(output.first));
+    if (ejecting) {actuator_set(actuator_roller2, millivolts(SORT_EJECT_VOLTAGE));}  // The colour sort throws blocks out the top
+    else {actuator_set(actuator_roller2, millivolts(output.second));}
+    actuator_write(actuator_roller1);
+    actuator_write(actuator_roller2);
 }
-#pragma endregion
\ No newline at end of file
+
+// @brief Prints how far apart the rollers have drifted to the terminal
+void rollers_print() {
+    printf("rollers: %s mode, %.1f deg drift now, %.1f deg worst\n", rollers.mode == ROLLERS_SYNC ? "sync" : "share", rollers.drift,
+           rollers.drift_worst);
+    rollers.drift_worst = 0.0;
+}
+#pragma endregion
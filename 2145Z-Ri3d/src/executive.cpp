@@ -0,0 +1,99 @@
+#include "executive.hpp"
+#include "main.h"
+#include "pros/rtos.hpp"
+
+// ** @file executive.cpp
+// ** @brief This file contains the fixed-rate control executive.
+// ** @details Callbacks are scheduled against absolute timestamps, so a slow body delays the callbacks
+// after it in the same tick but never shifts the period of anything. Start jitter, body time and overruns
+// are kept per callback and can be printed to the terminal.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region registration
+// @brief Registers a callback with the executive
+// @param name The name printed next to the callback's statistics
+// @param rate_hz How many times per second the callback should run
+// @param fn The function to run
+// @details Callbacks run in the order they are added. The period is rounded up to a multiple of EXEC_TICK,
+// so anything faster than 1000 / EXEC_TICK Hz runs at that rate instead.
+// @note Callbacks must be added before exec_start() is called.
+void exec_add(std::string name, uint32_t rate_hz, std::function<void()> fn) {
+    if (exec_running) {
+        printf("exec: can't add %s after the executive has started\n", name.c_str());
+        return;
+    }
+    uint32_t period = rate_hz > 0 ? 1000 / rate_hz : 1000;
+    period = ((period + EXEC_TICK - 1) / EXEC_TICK) * EXEC_TICK;
+    if (period == 0) {period = EXEC_TICK;}
+    exec_callbacks.emplace_back(name, period, fn);
+}
+
+// @brief Starts the executive task
+void exec_start() {
+    if (exec_running) {return;}
+    exec_running = true;
+    pros::Task executiveTask(exec_t, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "executive");
+}
+#pragma endregion
+
+#pragma region statistics
+// @brief Prints the statistics of every callback to the terminal
+void exec_print() {
+    printf("%-12s %6s %10s %8s %8s %8s %6s %6s\n", "callback", "ms", "ns/iter", "worst", "jit avg", "jit max", "over", "skip");
+    for (exec_callback& cb : exec_callbacks) {
+        double jitter_mean = cb.timer.count > 0 ? (double)cb.jitter_total / cb.timer.count : 0.0;
+        printf("%-12s %6lu %10.0f %6luus %6.0fus %6luus %6lu %6lu\n", cb.timer.name.c_str(), (unsigned long)cb.period, cb.timer.mean_ns(),
+               (unsigned long)cb.timer.worst_us, jitter_mean, (unsigned long)cb.jitter_worst, (unsigned long)cb.overruns, (unsigned long)cb.skipped);
+    }
+}
+
+// @brief Clears the statistics of every callback
+void exec_reset() {
+    for (exec_callback& cb : exec_callbacks) {
+        cb.timer.reset();
+        cb.jitter_worst = 0;
+        cb.jitter_total = 0;
+        cb.overruns = 0;
+        cb.skipped = 0;
+    }
+}
+#pragma endregion
+
+#pragma region task
+// @brief The executive task
+// @details Wakes every EXEC_TICK ms and runs each callback whose next_run time has come. If a callback
+// falls more than a whole period behind, the missed runs are counted and dropped instead of being run back to back.
+// The schedule and the jitter are both in pros::micros(), so millisecond rounding doesn't show up as jitter. The
+// task can only wake on millisecond ticks, so a callback due within half a tick runs now rather than a tick late.
+void exec_t() {
+    uint32_t wake = pros::millis();
+    uint64_t start = pros::micros();
+    for (exec_callback& cb : exec_callbacks) {cb.next_run = start;}
+
+    while (true) {
+        uint64_t now = pros::micros();
+        for (exec_callback& cb : exec_callbacks) {
+            if ((int64_t)(now - cb.next_run) < -(int64_t)EXEC_TICK * 500) {continue;}
+
+            // How far from when it was scheduled this run started, early or late
+            int64_t late = (int64_t)(pros::micros() - cb.next_run);
+            uint32_t jitter = late > 0 ? late : -late;
+            cb.jitter_total += jitter;
+            if (jitter > cb.jitter_worst) {cb.jitter_worst = jitter;}
+
+            cb.timer.start();
+            cb.fn();
+            cb.timer.stop();
+            if (cb.timer.last_us > cb.period * 1000) {cb.overruns++;}
+
+            uint64_t period_us = cb.period * 1000;
+            cb.next_run += period_us;
+            while ((int64_t)(pros::micros() - cb.next_run) >= (int64_t)period_us) {
+                cb.next_run += period_us;
+                cb.skipped++;
+            }
+        }
+        pros::Task::delay_until(&wake, EXEC_TICK);
+    }
+}
+#pragma endregion
@@ -0,0 +1,43 @@
+#include "loop_timer.hpp"
+#include "main.h"
+#include "pros/rtos.hpp"
+
+// ** @file loop_timer.cpp
+// ** @brief This file contains the timer used to measure how long each control loop body takes.
+// ** @details The ez::Drive PID and odometry loops run inside EZ-Template's own task and can't be wrapped from here,
+// so these timers cover the loop bodies this project owns. Everything is printed to the terminal in ns/iteration
+// so it can be compared directly against the loop period.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region timer
+// @brief Marks the start of an iteration
+void loop_timer::start() { start_time = pros::micros(); }
+
+// @brief Marks the end of an iteration and folds its length into the statistics
+void loop_timer::stop() {
+    last_us = pros::micros() - start_time;
+    total_us += last_us;
+    if (last_us > worst_us) {worst_us = last_us;}
+    count++;
+}
+
+// @brief Clears all of the statistics
+void loop_timer::reset() {
+    count = 0;
+    total_us = 0;
+    worst_us = 0;
+    last_us = 0;
+}
+
+// @brief Gets the average length of an iteration
+// @return The average iteration time in nanoseconds, or 0 if nothing has been measured
+double loop_timer::mean_ns() const {
+    if (count == 0) {return 0.0;}
+    return total_us * 1000.0 / count;
+}
+
+// @brief Prints the statistics to the terminal
+void loop_timer::print() const {
+    printf("%-12s %8.0f ns/iter  worst %6lu us  (%lu iters)\n", name.c_str(), mean_ns(), (unsigned long)worst_us, (unsigned long)count);
+}
+#pragma endregion
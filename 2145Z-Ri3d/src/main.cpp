@@ -14,10 +14,13 @@
  * to keep execution time for this mode under a few seconds.
  */
 void initialize() {
+  startup_begin(3);  // Times the background jobs below
+
   // Print our branding over your terminal :D
   ez::ez_template_print();
 
-  pros::delay(500);  // Stop the user from doing anything while legacy ports configure
+  // There's no pros::delay(500) for legacy ports to configure here, we don't use any three wire devices.
+  // Add it back if a three wire sensor is plugged in.
 
   // Configure your chassis controls
   chassis.opcontrol_curve_buttons_toggle(true);   // Enables modifying the controller curve with buttons on the joysticks
@@ -25,6 +28,8 @@ void initialize() {
   chassis.opcontrol_curve_default_set(0.0, 0.0);  // Defaults for curve. If using tank, only the first parameter is used. (Comment this line out if you have an SD card!)
 
   default_constants();
+  battery_start();  // Scales the gains default_constants() just set for the battery from now on
+  paths_init();  // Generate pure pursuit paths now instead of during autonomous
 
   // Autonomous Selector using LLEMU
   ez::as::auton_selector.autons_add({
@@ -41,13 +46,54 @@ void initialize() {
       {"Pure Pursuit Wait Until\n\nGo to (24, 24) but start running an intake once the robot passes (12, 24)", odom_pure_pursuit_wait_until_example},
       {"Boomerang\n\nGo to (0, 24, 45) then come back to (0, 0, 0)", odom_boomerang_example},
       {"Boomerang Pure Pursuit\n\nGo to (0, 24, 45) on the way to (24, 24) then come back to (0, 0, 0)", odom_boomerang_injected_pure_pursuit_example},
+      {"Trajectory\n\nFollow a squiggles S curve to (24, 24, 90) then back to (0, 0, 0)", odom_trajectory_example},
+      {"Profiled Drive\n\nDrive forward and back on S-curve motion profiles", profile_drive_example},
       {"Measure Offsets\n\nThis will turn the robot a bunch of times and calculate your offsets for your tracking wheels.", measure_offsets},
+      {"Measure Feedforward\n\nThis will drive forward and back and turn on the spot to measure kS, kV and kA. Leave 2 tiles clear in front.", measure_feedforward},
   });
 
-  // Initialize chassis and auton selector
-  chassis.initialize();
-  ez::as::initialize();
-  master.rumble(chassis.drive_imu_calibrated() ? "." : "---");
+  // Initialize chassis and auton selector in the background, this is what chassis.initialize() does
+  // - autonomous() checks startup_imu before it drives, see there for what happens if it isn't ready
+  // - the job only calibrates, so it never resets anything under an auton that gave up waiting for it
+  chassis.drive_sensor_reset();
+  odom_start();  // 200Hz odometry, uses the drive encoders for heading until the IMU is calibrated, or if it failed
+  startup_run(startup_imu, []() {
+    bool calibrated = chassis.drive_imu_calibrate(false);  // No loading animation, the selector is using the screen
+    master.rumble(calibrated ? "." : "---");
+    return calibrated;
+  });
+  startup_run(startup_curve, []() {
+    startup_sd_mutex.take();
+    chassis.opcontrol_curve_sd_initialize();
+    startup_sd_mutex.give();
+    return true;
+  });
+  startup_run(startup_selector, []() {
+    startup_sd_mutex.take();
+    ez::as::initialize();
+    startup_sd_mutex.give();
+    return true;
+  });
+
+  // Register every subsystem loop with the executive, these run in the order they're added
+  exec_add("driver", 1000 / ez::util::DELAY_TIME, driver_iterate);  // Keep this at ez::util::DELAY_TIME, EZ-Template's opcontrol timers depend on it
+  exec_add("trajectory", 1000 / ez::util::DELAY_TIME, trajectory_iterate);
+  exec_add("profile", 1000 / ez::util::DELAY_TIME, profile_iterate);
+  exec_add("pursuit", 1000 / ez::util::DELAY_TIME, pursuit_iterate);
+  exec_add("intake", 100, intake_iterate);
+  sort_init();
+  exec_add("sort", SORT_RATE, sort_iterate);  // Before the rollers so an eject starts the same tick
+  rollers_init();
+  exec_add("rollers", SORT_RATE, rollers_iterate);  // As fast as the sort, so ejects aren't held up
+  exec_add("screen", 10, ez_screen_iterate);
+  exec_add("battery", BATTERY_RATE, battery_iterate);
+  exec_add("telemetry", TELEMETRY_RATE, telemetry_record);
+  exec_start();
+
+  // Drain telemetry in the background, this only uses time the control tasks leave over
+  recorder_start_pending = true;  // Also log every frame to the SD card, if one is inserted
+  pros::Task telemetryTask(telemetry_t, TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT, "telemetry");
+  // telemetry_print_toggle(true);  // Uncomment to stream every chassis PID to the terminal as CSV
 }
 
 /**
@@ -56,7 +102,8 @@ void initialize() {
  * the robot is enabled, this task will exit.
  */
 void disabled() {
-  // . . .
+  recorder_stop_pending = true;  // Close the log so the last partial block makes it to the SD card
+  calib_save();  // Keep what the odom task learned about the tracker offsets and IMU for next time
 }
 
 /**
@@ -84,10 +131,11 @@ void competition_initialize() {
  * from where it left off.
  */
 void autonomous() {
+  isAuto = true;                              // Stops driver inputs from overriding subsystems
+  recorder_start_pending = true;              // Start a new flight log if disabled() closed the last one
+
   chassis.pid_targets_reset();                // Resets PID targets to 0
-  chassis.drive_imu_reset();                  // Reset gyro position to 0
-  chassis.drive_sensor_reset();               // Reset drive sensors to 0
-  chassis.odom_xyt_set(0_in, 0_in, 0_deg);    // Set the current position, you can start at a specific position with this
+  odom_fast_reset(0, 0, 0);                   // Reset the gyro and drive sensors to 0 and set the current position, you can start at a specific position with this
   chassis.drive_brake_set(MOTOR_BRAKE_HOLD);  // Set motors to hold.  This helps autonomous consistency
 
   /*
@@ -103,6 +151,14 @@ void autonomous() {
   to be consistent
   */
 
+  // If the IMU still isn't calibrated, every turn and heading correction would be wrong.
+  // Give it a moment, then drive straight off the line without the IMU instead of running the selected auton.
+  if (!startup_imu.wait(STARTUP_IMU_GRACE)) {
+    printf("auton: IMU %s, running the fallback\n", startup_imu.ready ? "failed to calibrate" : "isn't ready");
+    drive_no_imu();
+    return;
+  }
+
   ez::as::auton_selector.selected_auton_call();  // Calls selected auton from autonomous selector
 }
 
@@ -120,43 +176,38 @@ void screen_print_tracker(ez::tracking_wheel *tracker, std::string name, int lin
 }
 
 /**
- * Ez screen task
+ * Ez screen iteration
  * Adding new pages here will let you view them during user control or autonomous
  * and will help you debug problems you're having
  */
-void ez_screen_task() {
-  while (true) {
-    // Only run this when not connected to a competition switch
-    if (!pros::competition::is_connected()) {
-      // Blank page for odom debugging
-      if (chassis.odom_enabled() && !chassis.pid_tuner_enabled()) {
-        // If we're on the first blank page...
-        if (ez::as::page_blank_is_on(0)) {
-          // Display X, Y, and Theta
-          ez::screen_print("x: " + util::to_string_with_precision(chassis.odom_x_get()) +
-                               "\ny: " + util::to_string_with_precision(chassis.odom_y_get()) +
-                               "\na: " + util::to_string_with_precision(chassis.odom_theta_get()),
-                           1);  // Don't override the top Page line
-
-          // Display all trackers that are being used
-          screen_print_tracker(chassis.odom_tracker_left, "l", 4);
-          screen_print_tracker(chassis.odom_tracker_right, "r", 5);
-          screen_print_tracker(chassis.odom_tracker_back, "b", 6);
-          screen_print_tracker(chassis.odom_tracker_front, "f", 7);
-        }
-      }
-    }
+void ez_screen_iterate() {
+  // Only run this when not connected to a competition switch
+  if (!pros::competition::is_connected()) {
+    // Blank page for odom debugging
+    if (chassis.odom_enabled() && !chassis.pid_tuner_enabled()) {
+      // If we're on the first blank page...
+      if (ez::as::page_blank_is_on(0)) {
+        // Display X, Y, and Theta
+        ez::screen_print("x: " + util::to_string_with_precision(chassis.odom_x_get()) +
+                             "\ny: " + util::to_string_with_precision(chassis.odom_y_get()) +
+                             "\na: " + util::to_string_with_precision(chassis.odom_theta_get()),
+                         1);  // Don't override the top Page line
 
-    // Remove all blank pages when connected to a comp switch
-    else {
-      if (ez::as::page_blank_amount() > 0)
-        ez::as::page_blank_remove_all();
+        // Display all trackers that are being used
+        screen_print_tracker(chassis.odom_tracker_left, "l", 4);
+        screen_print_tracker(chassis.odom_tracker_right, "r", 5);
+        screen_print_tracker(chassis.odom_tracker_back, "b", 6);
+        screen_print_tracker(chassis.odom_tracker_front, "f", 7);
+      }
     }
+  }
 
-    pros::delay(ez::util::DELAY_TIME);
+  // Remove all blank pages when connected to a comp switch
+  else {
+    if (ez::as::page_blank_amount() > 0)
+      ez::as::page_blank_remove_all();
   }
 }
-pros::Task ezScreenTask(ez_screen_task);
 
 /**
  * Gives you some extras to run in your opcontrol:
@@ -179,10 +230,27 @@ void ez_template_extras() {
       chassis.pid_tuner_toggle();
 
     // Trigger the selected autonomous routine
+    // - this runs in its own task so the executive keeps running the other subsystems
     if (master.get_digital(DIGITAL_B) && master.get_digital(DIGITAL_DOWN)) {
-      pros::motor_brake_mode_e_t preference = chassis.drive_brake_get();
-      autonomous();
-      chassis.drive_brake_set(preference);
+      isAuto = true;  // Set before the task starts so holding the buttons doesn't start it twice
+      pros::Task([]() {
+        pros::motor_brake_mode_e_t preference = chassis.drive_brake_get();
+        autonomous();
+        chassis.drive_brake_set(preference);
+        isAuto = false;
+      });
+    }
+
+    // Print how long each executive callback is taking, then start measuring again
+    if (master.get_digital_new_press(DIGITAL_UP) && !chassis.pid_tuner_enabled()) {
+      exec_print();
+      exec_reset();
+      odom_timer.print();
+      odom_timer.reset();
+      sort_print();
+      intake_print();
+      rollers_print();
+      battery_print();
     }
 
     // Allow PID Tuner to iterate
@@ -196,6 +264,19 @@ void ez_template_extras() {
   }
 }
 
+/**
+ * Runs one iteration of driver control.  This is registered with the executive in initialize()
+ * and does nothing unless the robot is in driver control.
+ */
+void driver_iterate() {
+  if (isAuto || pros::competition::is_disabled() || pros::competition::is_autonomous()) return;
+
+  // Gives you some extras to make EZ-Template ezier
+  ez_template_extras();
+
+  chassis.opcontrol_tank();  // Tank control
+}
+
 /**
  * Runs the operator control code. This function will be started in its own task
  * with the default priority and stack size whenever the robot is enabled via
@@ -213,12 +294,7 @@ void opcontrol() {
   // This is preference to what you like to drive on
   chassis.drive_brake_set(MOTOR_BRAKE_COAST);
 
-  while (true) {
-    // Gives you some extras to make EZ-Template ezier
-    ez_template_extras();
-
-    chassis.opcontrol_tank();  // Tank control
-
-    pros::delay(ez::util::DELAY_TIME);  // This is used for timer calculations!  Keep this ez::util::DELAY_TIME
-  }
+  // Hand the subsystems back to the driver, driver_iterate() takes it from here
+  isAuto = false;
+  recorder_start_pending = true;  // Start a new flight log if disabled() closed the last one
 }
@@ -0,0 +1,283 @@
+#include "odometry.hpp"
+#include "main.h"
+#include "pros/rtos.hpp"
+
+// ** @file odometry.cpp
+// ** @brief This file contains the high-rate odometry task.
+// ** @details Every ODOM_PERIOD ms the tracking wheels and drive encoders are fused into one step forwards, the IMU
+// gives the change in heading, and the EKF is moved along the arc. GPS fixes and distance sensor readings off the
+// field walls correct the pose when they're enabled.
+// If the parallel tracking wheel isn't plugged in, only the drive encoders are used.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region seqlock
+// @brief Publishes a new pose and covariance
+// @details Only the odom task calls this. The sequence number is odd while the estimate is being written.
+void pose_seqlock::write(const pose_ekf& ekf) {
+    double next[9] = {ekf.x, ekf.y, ekf.theta, ekf.P[0][0], ekf.P[0][1], ekf.P[0][2], ekf.P[1][1], ekf.P[1][2], ekf.P[2][2]};
+    uint32_t s = seq.load(std::memory_order_relaxed);
+    seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int i = 0; i < 9; i++) {values[i].store(next[i], std::memory_order_relaxed);}
+    seq.store(s + 2, std::memory_order_release);
+}
+
+// @brief Reads the latest pose and covariance
+// @return The estimate, never half of one write and half of another
+// @details This never waits on a lock. The odom task runs at a higher priority than everything that reads the pose,
+// so a write can't be interrupted by a reader and a retry is only needed when a reader is interrupted by a write.
+odom_estimate pose_seqlock::read() const {
+    double v[9];
+    uint32_t before, after;
+    do {
+        before = seq.load(std::memory_order_acquire);
+        for (int i = 0; i < 9; i++) {v[i] = values[i].load(std::memory_order_relaxed);}
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = seq.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    odom_estimate estimate;
+    estimate.pose = {v[0], v[1], v[2]};
+    double cov[3][3] = {{v[3], v[4], v[5]}, {v[4], v[6], v[7]}, {v[5], v[7], v[8]}};
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {estimate.cov[i][j] = cov[i][j];}
+    }
+    return estimate;
+}
+#pragma endregion
+
+#pragma region sensors
+// @brief Converts a tracking wheel's position to inches
+// @param sensor The tracking wheel's rotation sensor
+// @return The distance the wheel has rolled, in inches
+static double odom_tracker_inches(pros::Rotation& sensor) {
+    int32_t centidegrees = sensor.get_position();
+    if (centidegrees == PROS_ERR) {return 0.0;}
+    return centidegrees / 36000.0 * M_PI * ODOM_DIAMETER;
+}
+
+// @brief Reads the scaled, unwrapped IMU heading
+// @return The heading in degrees, PROS_ERR_F if the IMU can't be read
+static double odom_heading_get() {
+    double rotation = imu.get_rotation();
+    if (rotation == PROS_ERR_F) {return PROS_ERR_F;}
+    return rotation * chassis.drive_imu_scaler_get();
+}
+
+// @brief Reads every odometry sensor
+static odom_readings odom_readings_get() {
+    odom_readings readings;
+    if (odom_use_trackers) {
+        readings.vert = odom_tracker_inches(odom_vert);
+        readings.horiz = odom_tracker_inches(odom_horiz);
+    }
+    readings.left = chassis.drive_sensor_left();
+    readings.right = chassis.drive_sensor_right();
+    readings.heading = odom_heading_get();
+    return readings;
+}
+#pragma endregion
+
+#pragma region fusion
+// @brief Moves the EKF along one sample of the trackers, drive encoders and IMU
+// @param now The readings this sample
+// @details The IMU gives the change in heading, or the drive encoders if it drops a sample. The forwards step is
+// the trackers and drive encoders weighted by how much each is trusted, unless they disagree by more than
+// slip_sigma, then the drive encoders have slipped and only the tracker is used.
+static void odom_predict(const odom_readings& now) {
+    double d_left = now.left - odom_last.left;
+    double d_right = now.right - odom_last.right;
+    double d_ime = (d_left + d_right) / 2.0;
+
+    double d_theta, var_theta;
+    if (now.heading != PROS_ERR_F && odom_last.heading != PROS_ERR_F) {
+        d_theta = now.heading - odom_last.heading;
+        var_theta = odom_noise.imu_var * fabs(d_theta) + odom_noise.imu_drift_var;
+    } else {
+        d_theta = ez::util::to_deg((d_right - d_left) / DRIVE_WIDTH);
+        var_theta = odom_noise.ime_theta_var * fabs(d_theta) + odom_noise.imu_drift_var;
+    }
+
+    double ime_x, ime_y;
+    odom_arc_local(d_ime, 0.0, d_theta, 0.0, 0.0, ime_x, ime_y);
+    double var_ime = odom_noise.ime_var * fabs(d_ime);
+
+    double local_x = ime_x, local_y = ime_y, var_along = var_ime, var_cross = var_ime;
+    if (odom_use_trackers) {
+        double d_vert = now.vert - odom_last.vert;
+        double d_horiz = now.horiz - odom_last.horiz;
+        odom_arc_local(d_vert, d_horiz, d_theta, calib_vert_offset(), calib_horiz_offset(), local_x, local_y);
+        double var_tracker = odom_noise.tracker_var * fabs(d_vert);
+        var_cross = odom_noise.tracker_var * fabs(d_horiz);
+
+        double limit = odom_noise.slip_sigma * sqrt(var_tracker + var_ime);
+        if (fabs(local_y - ime_y) <= limit) {
+            local_y = ekf_fuse(local_y, var_tracker, ime_y, var_ime, var_along);
+        } else {
+            var_along = var_tracker;
+        }
+
+        // Only turns measured by the IMU say anything about the offsets
+        if (now.heading != PROS_ERR_F && odom_last.heading != PROS_ERR_F) {calib_sample(d_vert, d_horiz, d_ime, d_theta);}
+    }
+
+    ekf_predict(odom_ekf, local_x, local_y, d_theta, var_along, var_cross, var_theta);
+}
+
+// @brief Corrects the EKF with a GPS fix
+// @details The GPS reports meters from the center of the field, so this only makes sense once the pose has been
+// set in the same frame, in inches with the origin at the center of the field.
+static void odom_gps_update() {
+    pros::gps_status_s_t status = gps.get_position_and_orientation();
+    double error = gps.get_error();
+    double heading = gps.get_heading();
+    if (status.x == PROS_ERR_F || error == PROS_ERR_F || heading == PROS_ERR_F) {return;}
+    if (error > ODOM_GPS_MAX_ERROR) {return;}
+
+    double var_xy = pow(std::max(error, 0.005) * 39.37, 2);
+    const double H_x[3] = {1.0, 0.0, 0.0};
+    const double H_y[3] = {0.0, 1.0, 0.0};
+    const double H_theta[3] = {0.0, 0.0, 1.0};
+    ekf_update(odom_ekf, H_x, status.x * 39.37, var_xy, ODOM_GATE);
+    ekf_update(odom_ekf, H_y, status.y * 39.37, var_xy, ODOM_GATE);
+    ekf_update(odom_ekf, H_theta, heading, ODOM_GPS_THETA_VAR, ODOM_GATE, true);
+
+    double rotation = imu.get_rotation();
+    if (rotation != PROS_ERR_F) {calib_gps_sample(heading, rotation);}
+}
+
+// @brief Corrects the EKF with the distance sensors that can see a field wall
+// @details Sensors are checked round robin and this stops once it has used ODOM_RELOC_BUDGET us, so adding sensors
+// can't slow the odom task down. Each correction is a few ray casts against the field map.
+static void odom_reloc_update() {
+    static size_t next = 0;
+    uint64_t start = pros::micros();
+    for (size_t i = 0; i < odom_reloc_sensors.size(); i++) {
+        if (pros::micros() - start > ODOM_RELOC_BUDGET) {break;}
+        reloc_sensor& reloc = odom_reloc_sensors[next];
+        next = (next + 1) % odom_reloc_sensors.size();
+
+        int32_t mm = reloc.sensor->get();
+        int32_t confidence = reloc.sensor->get_confidence();
+        if (mm == PROS_ERR || confidence == PROS_ERR || mm <= 0 || mm > ODOM_RELOC_MAX_RANGE || confidence < ODOM_RELOC_CONFIDENCE) {
+            reloc.skipped++;
+            continue;
+        }
+
+        // The sensor is accurate to 15mm up close and 5% further out
+        double inches = mm / 25.4;
+        double sigma = std::max(15.0, mm * 0.05) / 25.4;
+        if (reloc_correct(odom_ekf, reloc.mount, inches, sigma * sigma, push_back_walls, std::size(push_back_walls), odom_reloc_settings)) {
+            reloc.used++;
+        } else {
+            reloc.skipped++;
+        }
+    }
+}
+#pragma endregion
+
+#pragma region interface
+// @brief Starts the odometry task
+// @note Call this once in initialize(). It can start while the IMU calibrates, the IMU can't be read until it's done
+// so the drive encoders give the heading until then.
+void odom_start() {
+    odom_use_trackers = odom_vert.get_position() != PROS_ERR;
+    if (odom_use_trackers) {
+        odom_vert.set_data_rate(ODOM_DATA_RATE);
+        odom_horiz.set_data_rate(ODOM_DATA_RATE);
+    } else {
+        printf("odom: no tracking wheel on port %i, using the drive encoders\n", PORT_ODOM_VERT);
+    }
+    imu.set_data_rate(ODOM_DATA_RATE);
+    calib_load();
+
+    odom_last = odom_readings_get();
+    ekf_reset(odom_ekf, 0.0, 0.0, 0.0, ODOM_RESET_VAR_XY, ODOM_RESET_VAR_THETA);
+    odom_pose.write(odom_ekf);
+    pros::Task odomTask(odom_t, TASK_PRIORITY_MAX - 2, TASK_STACK_DEPTH_DEFAULT, "odom");
+}
+
+// @brief Gets the latest pose from the odom task
+// @return x and y in inches, theta in degrees
+ez::pose odom_fast_get() {
+    return odom_pose.read().pose;
+}
+
+// @brief Gets the latest pose from the odom task along with how sure it is
+// @return The pose and its covariance
+odom_estimate odom_estimate_get() {
+    return odom_pose.read();
+}
+
+// @brief Sets the pose of both the odom task and EZ-Template's odometry
+// @param x The new x in inches
+// @param y The new y in inches
+// @param theta The new heading in degrees
+// @details The odom task applies the new pose on its next update, so it can be called from any task.
+void odom_fast_xyt_set(double x, double y, double theta) {
+    odom_reset_pose = {x, y, theta};
+    odom_reset_pending.store(true, std::memory_order_release);
+    chassis.odom_xyt_set(x, y, theta);
+}
+
+// @brief Zeroes the IMU and drive sensors and sets the pose, without the odom task seeing the jump as motion
+// @param x The new x in inches
+// @param y The new y in inches
+// @param theta The new heading in degrees
+// @details The odom task runs above every other task and can take a sample between any two of these resets. While
+// odom_hold is set it only re-reads its baselines, so nothing is integrated or fed to the calibration, until the
+// pose reset is queued. Use this instead of resetting the sensors and calling odom_fast_xyt_set() separately.
+void odom_fast_reset(double x, double y, double theta) {
+    odom_hold.store(true, std::memory_order_release);
+    chassis.drive_imu_reset();
+    chassis.drive_sensor_reset();
+    odom_fast_xyt_set(x, y, theta);
+    odom_hold.store(false, std::memory_order_release);
+}
+
+// @brief Zeroes the drive sensors and keeps the pose
+// @details Like odom_fast_reset(), but the odom task only takes new baselines after the reset instead of resetting
+// the EKF. Use this instead of chassis.drive_sensor_reset() once the odom task is running.
+void odom_sensor_reset() {
+    odom_hold.store(true, std::memory_order_release);
+    chassis.drive_sensor_reset();
+    odom_rebase_pending.store(true, std::memory_order_release);
+    odom_hold.store(false, std::memory_order_release);
+}
+#pragma endregion
+
+#pragma region task
+// @brief The odometry task
+// @details Runs every ODOM_PERIOD ms against absolute timestamps. It sits above the executive so that nothing
+// else can delay a sample.
+void odom_t() {
+    uint32_t now = pros::millis();
+    uint32_t gps_next = now;
+    uint32_t reloc_next = now;
+    while (true) {
+        odom_timer.start();
+        odom_readings readings = odom_readings_get();
+
+        if (odom_reset_pending.exchange(false, std::memory_order_acquire)) {
+            ekf_reset(odom_ekf, odom_reset_pose.x, odom_reset_pose.y, odom_reset_pose.theta, ODOM_RESET_VAR_XY, ODOM_RESET_VAR_THETA);
+            calib_restart();
+        } else if (!odom_hold.load(std::memory_order_acquire) && !odom_rebase_pending.exchange(false, std::memory_order_acquire)) {
+            odom_predict(readings);
+        }
+        odom_last = readings;
+
+        if (odom_gps_enabled && (int32_t)(now - gps_next) >= 0) {
+            odom_gps_update();
+            gps_next = now + ODOM_GPS_PERIOD;
+        }
+        if (odom_reloc_enabled && (int32_t)(now - reloc_next) >= 0) {
+            odom_reloc_update();
+            reloc_next = now + ODOM_RELOC_PERIOD;
+        }
+        odom_pose.write(odom_ekf);
+        odom_timer.stop();
+
+        pros::Task::delay_until(&now, ODOM_PERIOD);
+    }
+}
+#pragma endregion
@@ -0,0 +1,189 @@
+#include "path_cache.hpp"
+#include "main.h"
+
+// ** @file path_cache.cpp
+// ** @brief This file contains the pure pursuit path cache.
+// ** @details Paths are injected at odom_path_spacing_get() and smoothed with odom_path_smooth_constants_get(), the same
+// constants pid_odom_smooth_pp_set() uses, then handed to pid_odom_pp_set() so the chassis doesn't redo the work.
+// pid_pursuit_set() follows the same points.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region generation
+// @brief Fills in points along every segment of a path
+// @param start Where the robot starts the path from
+// @param waypoints The points to drive through
+// @param spacing The distance between injected points in inches
+// @return The path with a point every spacing inches, each point keeps the speed and direction of the waypoint it leads to
+std::vector<ez::odom> path_inject(ez::pose start, const std::vector<ez::odom>& waypoints, double spacing) {
+    std::vector<ez::odom> points;
+    ez::pose from = start;
+    for (const ez::odom& waypoint : waypoints) {
+        double distance = ez::util::distance_to_point(waypoint.target, from);
+        int count = spacing > 0.0 ? distance / spacing : 0;
+        for (int i = 0; i < count; i++) {
+            double t = i * spacing / distance;
+            ez::odom point = waypoint;
+            point.target = {from.x + (waypoint.target.x - from.x) * t, from.y + (waypoint.target.y - from.y) * t};
+            points.push_back(point);
+        }
+        from = waypoint.target;
+    }
+    points.push_back(waypoints.back());
+    return points;
+}
+
+// @brief Smooths a path with gradient descent
+// @param path The injected path
+// @param weight_smooth How much each point is pulled towards its neighbours
+// @param weight_data How much each point is pulled back towards where it started
+// @param tolerance Stop once a full pass moves the points less than this in total
+// @return The smoothed path, the first and last points don't move
+std::vector<ez::odom> path_smooth(const std::vector<ez::odom>& path, double weight_smooth, double weight_data, double tolerance) {
+    std::vector<ez::odom> smoothed = path;
+    if (tolerance <= 0.0) {return smoothed;}  // Would never converge
+    double change = tolerance;
+    while (change >= tolerance) {
+        change = 0.0;
+        for (size_t i = 1; i + 1 < smoothed.size(); i++) {
+            double* cur[2] = {&smoothed[i].target.x, &smoothed[i].target.y};
+            double original[2] = {path[i].target.x, path[i].target.y};
+            double prev[2] = {smoothed[i - 1].target.x, smoothed[i - 1].target.y};
+            double next[2] = {smoothed[i + 1].target.x, smoothed[i + 1].target.y};
+            for (int j = 0; j < 2; j++) {
+                double before = *cur[j];
+                *cur[j] += weight_data * (original[j] - *cur[j]) + weight_smooth * (prev[j] + next[j] - 2.0 * *cur[j]);
+                change += fabs(before - *cur[j]);
+            }
+        }
+    }
+    return smoothed;
+}
+
+// @brief Converts smoothed points for our pure pursuit follower
+// @param points The injected and smoothed path
+// @return The points measured by path_measure() and planned by path_plan() with pursuit_k
+// @details Each waypoint's max_xy_speed becomes what traj_k's feedforward says that drive_set output gets the robot
+// to on a full battery. Waypoint speeds are only a cap, path_plan() slows for corners and the end by itself.
+std::vector<path_point> path_pursuit_points(const std::vector<ez::odom>& points) {
+    double kS = (traj_k.left.kS + traj_k.right.kS) / 2.0;
+    double kV = (traj_k.left.kV + traj_k.right.kV) / 2.0;
+    std::vector<path_point> pursuit;
+    for (const ez::odom& point : points) {
+        path_point measured;
+        measured.x = point.target.x;
+        measured.y = point.target.y;
+        measured.speed = kV > 0.0 ? std::max(0.0, (point.max_xy_speed - kS) / kV) : 0.0;
+        measured.reversed = point.drive_direction == ez::rev;
+        pursuit.push_back(measured);
+    }
+    path_measure(pursuit);
+    path_plan(pursuit, pursuit_k);
+    return pursuit;
+}
+#pragma endregion
+
+#pragma region cache
+// @brief Checks if two paths would generate the same points
+static bool path_key_equal(const cached_path& a, const cached_path& b) {
+    if (a.start.x != b.start.x || a.start.y != b.start.y) {return false;}
+    if (a.spacing != b.spacing || a.smooth_constants != b.smooth_constants) {return false;}
+    if (a.waypoints.size() != b.waypoints.size()) {return false;}
+    for (size_t i = 0; i < a.waypoints.size(); i++) {
+        const ez::odom& wa = a.waypoints[i];
+        const ez::odom& wb = b.waypoints[i];
+        if (wa.target.x != wb.target.x || wa.target.y != wb.target.y || wa.target.theta != wb.target.theta) {return false;}
+        if (wa.drive_direction != wb.drive_direction || wa.max_xy_speed != wb.max_xy_speed) {return false;}
+        if (wa.turn_behavior != wb.turn_behavior) {return false;}
+    }
+    return true;
+}
+
+// @brief Gets the constants path_pursuit_points() plans with right now
+static std::vector<double> path_plan_constants() {
+    return {(traj_k.left.kS + traj_k.right.kS) / 2.0, (traj_k.left.kV + traj_k.right.kV) / 2.0, pursuit_k.max_accel,
+            pursuit_k.max_decel, pursuit_k.max_lateral};
+}
+
+// @brief Builds the cache key for a path with the chassis' current path constants
+static cached_path path_key(std::vector<ez::united_odom> path, ez::united_pose start) {
+    cached_path key;
+    key.start = ez::util::united_pose_to_pose(start);
+    key.waypoints = ez::util::united_odoms_to_odoms(path);
+    key.spacing = chassis.odom_path_spacing_get();
+    key.smooth_constants = chassis.odom_path_smooth_constants_get();
+    return key;
+}
+
+// @brief Generates a path and stores it in the cache
+// @param path The points to drive through, the same as you'd give pid_odom_set()
+// @param start Where the robot will be when the path starts, defaults to (0, 0)
+// @return How many points the cached path has, 0 if it couldn't be cached
+// @details Call this from initialize() after default_constants(). Adding the same path twice only generates it once.
+// @note Waypoints with an angle are boomerang targets and are left to the chassis, those paths aren't cached.
+int path_cache_add(std::vector<ez::united_odom> path, ez::united_pose start) {
+    cached_path key = path_key(path, start);
+    for (const cached_path& cached : path_cache) {
+        if (path_key_equal(cached, key)) {return cached.points.size();}
+    }
+    if (key.waypoints.empty() || key.smooth_constants.size() < 3) {return 0;}
+
+    for (const ez::odom& waypoint : key.waypoints) {
+        if (waypoint.target.theta != ez::ANGLE_NOT_SET) {
+            printf("path cache: paths with boomerang points can't be cached\n");
+            return 0;
+        }
+    }
+
+    std::vector<ez::odom> injected = path_inject(key.start, key.waypoints, key.spacing);
+    key.points = path_smooth(injected, key.smooth_constants[0], key.smooth_constants[1], key.smooth_constants[2]);
+    key.pursuit = path_pursuit_points(key.points);
+    key.plan_constants = path_plan_constants();
+    path_cache.push_back(key);
+    return path_cache.back().points.size();
+}
+
+// @brief Finds a path in the cache
+// @param path The points to drive through, the same as was given to path_cache_add()
+// @param start Where the path was cached from, defaults to (0, 0)
+// @return The path's index in path_cache, -1 if it isn't there or the path constants have changed since
+int path_cache_find(std::vector<ez::united_odom> path, ez::united_pose start) {
+    cached_path key = path_key(path, start);
+    for (size_t i = 0; i < path_cache.size(); i++) {
+        if (path_key_equal(path_cache[i], key)) {return i;}
+    }
+    return -1;
+}
+
+// @brief Gets a cached path's points for pid_pursuit_set(), planning them again if they're out of date
+// @param index The path's index in path_cache, from path_cache_find()
+// @return The measured and planned points
+// @details The planned speeds depend on traj_k and pursuit_k, not just the waypoints. measure_feedforward() and
+// ff_load() change traj_k after paths may have been cached, so the speeds are redone here when they don't match.
+const std::vector<path_point>& path_cache_pursuit(int index) {
+    cached_path& cached = path_cache[index];
+    std::vector<double> constants = path_plan_constants();
+    if (cached.plan_constants != constants) {
+        cached.pursuit = path_pursuit_points(cached.points);
+        cached.plan_constants = constants;
+    }
+    return cached.pursuit;
+}
+
+// @brief Starts a pure pursuit motion through a cached path
+// @param path The points to drive through, the same as you'd give pid_odom_set()
+// @param slew_on True to slew the start of the motion
+// @param start Where the path was cached from, defaults to (0, 0)
+// @details If the path wasn't cached in initialize(), or the path constants have changed since, this falls back to
+// pid_odom_set() and generates the path now like it normally would.
+void pid_odom_cached_set(std::vector<ez::united_odom> path, bool slew_on, ez::united_pose start) {
+    int index = path_cache_find(path, start);
+    if (index >= 0) {
+        chassis.pid_odom_pp_set(path_cache[index].points, slew_on);
+        battery_motion_start();
+        return;
+    }
+    printf("path cache: miss, generating the path now\n");
+    chassis.pid_odom_set(path, slew_on);
+    battery_motion_start();
+}
+#pragma endregion
@@ -0,0 +1,101 @@
+#include "profile_drive.hpp"
+#include "main.h"
+
+// ** @file profile_drive.cpp
+// ** @brief This file contains the motion profiled straight drive.
+// ** @details While a profile runs the chassis is in DISABLE, like the trajectory follower, so EZ-Template's PID
+// task leaves the motors alone. tools/profile_sim.cpp compares it with pid_drive_set() on a simulated drive.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region motion
+// @brief Starts a motion profiled straight drive with the default limits in profile_k
+// @param target Distance to drive, negative drives backwards
+void pid_profile_drive_set(okapi::QLength target) {
+    pid_profile_drive_set(target, profile_k.max_vel, profile_k.max_accel, profile_k.max_jerk);
+}
+
+// @brief Starts a motion profiled straight drive
+// @param target Distance to drive, negative drives backwards
+// @param max_vel Max velocity in in/s
+// @param max_accel Max acceleration in in/s^2
+// @param max_jerk Max jerk in in/s^3, 0 for a trapezoid
+// @details The heading held is the one pid_drive_set() would hold, the target of the last turn
+void pid_profile_drive_set(okapi::QLength target, double max_vel, double max_accel, double max_jerk) {
+    trajectory_stop();
+    pursuit_running = false;
+    chassis.drive_mode_set(ez::DISABLE);
+    profile_active = profile_make(target.convert(okapi::inch), max_vel, max_accel, max_jerk);
+    profile_left_start = chassis.drive_sensor_left();
+    profile_right_start = chassis.drive_sensor_right();
+    profile_heading = chassis.headingPID.target_get();
+    profile_traveled = 0.0;
+    profile_handoff = 0.0;
+    profile_start_time = pros::millis();
+    profile_running = true;
+}
+#pragma endregion
+
+#pragma region waits
+// @brief Waits until the drive has settled at the end of the profile
+void profile_wait() {
+    while (profile_running) {pros::delay(ez::util::DELAY_TIME);}
+    chassis.pid_wait();
+}
+
+// @brief Waits until the drive has gone a distance
+// @param target Distance from the start of the drive, the same sign as the drive
+void profile_wait_until(okapi::QLength target) {
+    double distance = target.convert(okapi::inch);
+    while (profile_running && fabs(profile_traveled) < fabs(distance)) {pros::delay(ez::util::DELAY_TIME);}
+    if (profile_running) {return;}
+
+    // The PID that settles the end measures from where it started
+    if (chassis.drive_mode_get() == ez::DRIVE) {chassis.pid_wait_until((distance - profile_handoff) * okapi::inch);}
+}
+
+// @brief Waits until the drive is nearly there, then lets the next motion start while it's still moving
+// @details Like pid_wait_quick_chain(), the next motion takes over from the profile chain inches early. If the
+// profile has already ended this is pid_wait_quick_chain() on the settling PID.
+// @note Chaining into another profiled drive starts that one from rest
+void profile_wait_quick_chain() {
+    double exit = fabs(profile_active.distance) - profile_k.chain;
+    while (profile_running && fabs(profile_traveled) < exit) {pros::delay(ez::util::DELAY_TIME);}
+    if (!profile_running && chassis.drive_mode_get() == ez::DRIVE) {chassis.pid_wait_quick_chain();}
+}
+#pragma endregion
+
+#pragma region following
+// @brief Runs one iteration of the profiled drive
+// @note This is registered with the executive in initialize()
+void profile_iterate() {
+    if (!profile_running) {return;}
+
+    // Someone else started a motion, let it have the drive
+    if (chassis.drive_mode_get() != ez::DISABLE) {
+        profile_running = false;
+        return;
+    }
+
+    double left = chassis.drive_sensor_left() - profile_left_start;
+    double right = chassis.drive_sensor_right() - profile_right_start;
+    profile_traveled = (left + right) / 2.0;
+
+    // Hand the end to EZ-Template's PID, it settles and its exit conditions say when it's done
+    double t = (pros::millis() - profile_start_time) / 1000.0;
+    if (t >= profile_duration(profile_active)) {
+        profile_handoff = profile_traveled;
+        profile_running = false;
+        chassis.pid_drive_set((profile_active.distance - profile_traveled) * okapi::inch, profile_k.settle_speed, false, true);
+        return;
+    }
+
+    // Feedforward from the profile plus a kP on how far behind it the drive is, and hold the heading
+    profile_sample ref = profile_at(profile_active, t);
+    double correction = profile_k.kP * (ref.pos - profile_traveled);
+    double turn = profile_k.k_heading * ez::util::wrap_angle(profile_heading - chassis.drive_imu_get());
+    double scale = battery_scale_get();
+    double left_output = trajectory_feedforward(traj_k.left, ref.vel, ref.acc) + (correction + turn) * scale;
+    double right_output = trajectory_feedforward(traj_k.right, ref.vel, ref.acc) + (correction - turn) * scale;
+    chassis.drive_set(ez::util::clamp(left_output, 127.0), ez::util::clamp(right_output, 127.0));
+}
+#pragma endregion
@@ -0,0 +1,126 @@
+#include "pursuit_drive.hpp"
+#include "main.h"
+
+// ** @file pursuit_drive.cpp
+// ** @brief This file contains our pure pursuit follower.
+// ** @details While a path runs the chassis is in DISABLE, like the trajectory follower and the profiled drive, so
+// EZ-Template's PID task leaves the motors alone. Paths come from path_cache, measured once when they were added.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region motion
+// @brief Starts following a pure pursuit path
+// @param path The points to drive through, the same as you'd give pid_odom_set()
+// @param start Where the path was cached from, defaults to (0, 0)
+// @details If the path wasn't cached in initialize(), or the path constants have changed since, it's generated now.
+// Each waypoint's speed and direction apply to the points leading up to it.
+void pid_pursuit_set(std::vector<ez::united_odom> path, ez::united_pose start) {
+    // The executive can run between any of these, and a stale path is replanned in place, so stop following first
+    pursuit_stop();
+    int index = path_cache_find(path, start);
+    if (index < 0) {
+        printf("pursuit: miss, generating the path now\n");
+        if (path_cache_add(path, start) == 0) {return;}
+        index = path_cache_find(path, start);
+    }
+    if (index < 0 || path_cache_pursuit(index).size() < 2) {return;}
+
+    trajectory_stop();
+    chassis.drive_mode_set(ez::DISABLE);
+    profile_running = false;  // Every follower drives the chassis in DISABLE, only one can have it
+    pursuit_path = index;
+    pursuit_at = pursuit_state();
+    pursuit_vel = 0.0;
+    pursuit_look = pursuit_k.look_min;
+    pursuit_running = true;  // Last, once everything above is in place
+}
+
+// @brief Stops the follower and the drive, if it's running
+void pursuit_stop() {
+    if (!pursuit_running) {return;}
+    pursuit_running = false;
+    chassis.drive_set(0, 0);
+}
+#pragma endregion
+
+#pragma region waits
+// @brief Waits until the drive has settled at the end of the path
+void pursuit_wait() {
+    while (pursuit_running) {pros::delay(ez::util::DELAY_TIME);}
+    chassis.pid_wait();
+}
+
+// @brief Waits until the robot passes a point on the path
+// @param target The point, it doesn't need to be a waypoint
+// @details The nearest path point to target is found once, then this waits for the follower's closest point to get
+// there. If EZ-Template has already taken over the end, it waits with pid_wait_until_point() instead.
+void pursuit_wait_until_point(ez::united_pose target) {
+    if (pursuit_path < 0) {return;}
+    ez::pose point = ez::util::united_pose_to_pose(target);
+    const std::vector<path_point>& path = path_cache[pursuit_path].pursuit;
+    size_t index = 0;
+    double best = INFINITY;
+    for (size_t i = 0; i < path.size(); i++) {
+        double distance = std::hypot(path[i].x - point.x, path[i].y - point.y);
+        if (distance < best) {
+            best = distance;
+            index = i;
+        }
+    }
+
+    while (pursuit_running && pursuit_at.closest < index) {pros::delay(ez::util::DELAY_TIME);}
+    if (pursuit_running || pursuit_at.closest >= index) {return;}
+    if (chassis.drive_mode_get() != ez::DISABLE) {chassis.pid_wait_until_point(target);}
+}
+#pragma endregion
+
+#pragma region following
+// @brief Runs one iteration of the pure pursuit follower
+// @note This is registered with the executive in initialize()
+void pursuit_iterate() {
+    if (!pursuit_running) {return;}
+
+    // Someone else started a motion, let it have the drive
+    if (chassis.drive_mode_get() != ez::DISABLE) {
+        pursuit_running = false;
+        return;
+    }
+
+    const std::vector<path_point>& path = path_cache[pursuit_path].pursuit;
+    ez::pose current = odom_fast_get();
+    pursuit_at.checked = 0;
+    pursuit_closest(path, pursuit_at, current.x, current.y);
+    const path_point& here = path[pursuit_at.closest];
+    const path_point& end = path.back();
+
+    // Hand the end to EZ-Template's odom PID, it settles and its exit conditions say when it's done
+    if (pursuit_at.closest + 1 >= path.size() || std::hypot(end.x - current.x, end.y - current.y) < pursuit_k.handoff) {
+        pursuit_running = false;
+        chassis.pid_odom_ptp_set({{end.x, end.y}, end.reversed ? ez::rev : ez::fwd, pursuit_k.settle_speed}, false);
+        return;
+    }
+
+    // Steer for the lookahead point
+    double tx, ty;
+    pursuit_look = pursuit_lookahead(pursuit_k, pursuit_vel, here.ahead);
+    pursuit_target(path, pursuit_at, current.x, current.y, pursuit_look, tx, ty);
+    double curvature = pursuit_curvature(current.x, current.y, current.theta, tx, ty, here.reversed);
+
+    // The planned speed, slowed more if the outside wheel can't keep up with the turn the robot is really making
+    double kS = (traj_k.left.kS + traj_k.right.kS) / 2.0;
+    double kV = (traj_k.left.kV + traj_k.right.kV) / 2.0;
+    double radius = trajectory_turn_radius();
+    double target = std::min(here.vel, pursuit_speed_limit(curvature, (127.0 - kS) / kV, radius));
+    double dt = ez::util::DELAY_TIME / 1000.0;
+    double change = ez::util::clamp(target - pursuit_vel, pursuit_k.max_accel * dt, -pursuit_k.max_decel * dt);
+    pursuit_vel += change;
+    double accel = change / dt;
+
+    // Feedforward for each side. Backwards only flips the speed, clockwise is clockwise whichever way it's driving.
+    double vel = here.reversed ? -pursuit_vel : pursuit_vel;
+    double turn = pursuit_vel * curvature * radius;
+    if (here.reversed) {accel = -accel;}
+    double left = trajectory_feedforward(traj_k.left, vel + turn, accel);
+    double right = trajectory_feedforward(traj_k.right, vel - turn, accel);
+    chassis.drive_set(ez::util::clamp(left, 127.0), ez::util::clamp(right, 127.0));
+}
+#pragma endregion
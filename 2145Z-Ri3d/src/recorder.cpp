@@ -0,0 +1,177 @@
+#include "recorder.hpp"
+#include "flight_log.hpp"
+#include "main.h"
+
+// ** @file recorder.cpp
+// ** @brief This file contains the SD card flight recorder.
+// ** @details Only the telemetry task calls into the recorder, so SD card writes happen at the lowest priority
+// and never hold up the executive. Frames are delta and varint encoded into a block in RAM, and each full block
+// is written and flushed in one go.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region channels
+// Number of channels in a record: time, mode, pose, raw sensors, motors and PIDs
+#define RECORDER_CHANNELS (10 + TELEMETRY_MOTORS * 2 + TLM_PID_COUNT * 6)
+
+// @brief Writes the name and scale of every channel into the file header
+// @details The order here has to match recorder_values()
+static void recorder_header_write() {
+    const char* motors[TELEMETRY_MOTORS] = {"lf", "lm", "lb", "rf", "rm", "rb", "intake", "roller1", "roller2"};
+    const char* pids[TLM_PID_COUNT] = {"turn", "drive", "heading", "swing", "xy", "odom_ang", "boomerang"};
+    const char* pid_fields[6] = {"target", "cur", "error", "output", "i", "d"};
+
+    std::vector<std::pair<std::string, float>> channels = {{"time_ms", 1}, {"mode", 1}, {"x", 100}, {"y", 100}, {"theta", 100},
+                                                               {"left_in", 1000}, {"right_in", 1000}, {"vert_in", 1000}, {"horiz_in", 1000}, {"imu_deg", 1000}};
+    for (const char* motor : motors) {
+        channels.push_back({std::string(motor) + "_mA", 1});
+        channels.push_back({std::string(motor) + "_mV", 1});
+    }
+    for (const char* pid : pids) {
+        for (const char* field : pid_fields) {channels.push_back({std::string(pid) + "_" + field, 100});}
+    }
+
+    uint8_t count[2];
+    flight_log_u16_put(count, channels.size());
+    uint8_t version = FLIGHT_LOG_VERSION;
+    fwrite(FLIGHT_LOG_MAGIC, 1, 8, recorder_file);
+    fwrite(&version, 1, 1, recorder_file);
+    fwrite(count, 1, 2, recorder_file);
+    recorder_bytes = 11;
+    for (auto& channel : channels) {
+        uint8_t length = channel.first.size();
+        fwrite(&length, 1, 1, recorder_file);
+        fwrite(channel.first.c_str(), 1, length, recorder_file);
+        fwrite(&channel.second, sizeof(float), 1, recorder_file);
+        recorder_bytes += 1 + length + sizeof(float);
+    }
+}
+
+// @brief Quantises a frame into one integer per channel
+// @param frame The frame to convert
+// @param values Where to write RECORDER_CHANNELS values
+static void recorder_values(const telemetry_frame& frame, int32_t* values) {
+    int n = 0;
+    values[n++] = frame.time / 1000;
+    values[n++] = frame.mode;
+    values[n++] = std::lround(frame.x * 100.0f);
+    values[n++] = std::lround(frame.y * 100.0f);
+    values[n++] = std::lround(frame.theta * 100.0f);
+    for (float sensor : {frame.left, frame.right, frame.vert, frame.horiz, frame.imu}) {
+        values[n++] = std::lround(sensor * 1000.0f);
+    }
+    for (int i = 0; i < TELEMETRY_MOTORS; i++) {
+        values[n++] = frame.current[i];
+        values[n++] = frame.voltage[i];
+    }
+    for (const pid_snapshot& pid : frame.pids) {
+        for (float field : {pid.target, pid.cur, pid.error, pid.output, pid.integral, pid.derivative}) {
+            values[n++] = std::lround(field * 100.0f);
+        }
+    }
+}
+#pragma endregion
+
+#pragma region encoding
+// Block being built in RAM, and the last values written into it
+static uint8_t block[FLIGHT_LOG_BLOCK];
+static size_t block_len = 0;
+static uint16_t block_records = 0;
+static int32_t block_prev[RECORDER_CHANNELS];
+
+// @brief Starts a new log file on the SD card
+// @return True if a file was opened
+// @details Picks the first unused /usd/flNNN.bin so older matches are never overwritten.
+bool recorder_start() {
+    if (recorder_file != nullptr) {return true;}
+    if (!pros::usd::is_installed()) {return false;}
+
+    char path[32];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(path, sizeof(path), "/usd/fl%03i.bin", i);
+        FILE* existing = fopen(path, "rb");
+        if (existing == nullptr) {
+            recorder_file = fopen(path, "wb");
+            break;
+        }
+        fclose(existing);
+    }
+    if (recorder_file == nullptr) {return false;}
+
+    recorder_header_write();
+    recorder_start_ms = pros::millis();
+    block_len = 0;
+    block_records = 0;
+    memset(block_prev, 0, sizeof(block_prev));
+    printf("recorder: logging to %s\n", path);
+    return true;
+}
+
+// @brief Appends a frame to the current block, writing the block out first if the frame might not fit
+// @param frame The frame to record
+void recorder_write(const telemetry_frame& frame) {
+    if (recorder_file == nullptr) {return;}
+
+    const size_t mask_len = (RECORDER_CHANNELS + 7) / 8;
+    if (block_len + mask_len + RECORDER_CHANNELS * 5 > FLIGHT_LOG_BLOCK) {recorder_flush();}
+
+    int32_t values[RECORDER_CHANNELS];
+    recorder_values(frame, values);
+
+    uint8_t* mask = block + block_len;
+    memset(mask, 0, mask_len);
+    block_len += mask_len;
+    for (int i = 0; i < RECORDER_CHANNELS; i++) {
+        int32_t delta = values[i] - block_prev[i];
+        if (delta == 0) {continue;}
+        mask[i / 8] |= 1 << (i % 8);
+        block_len += flight_log_varint_put(block + block_len, flight_log_zigzag(delta));
+        block_prev[i] = values[i];
+    }
+    block_records++;
+}
+
+// @brief Writes the current block to the SD card and starts a new one
+void recorder_flush() {
+    if (recorder_file == nullptr || block_records == 0) {return;}
+
+    uint8_t block_header[5] = {'B'};
+    flight_log_u16_put(block_header + 1, block_len);
+    flight_log_u16_put(block_header + 3, block_records);
+    startup_sd_mutex.take();
+    fwrite(block_header, 1, sizeof(block_header), recorder_file);
+    fwrite(block, 1, block_len, recorder_file);
+    fflush(recorder_file);
+    startup_sd_mutex.give();
+    recorder_bytes += sizeof(block_header) + block_len;
+
+    block_len = 0;
+    block_records = 0;
+    memset(block_prev, 0, sizeof(block_prev));
+}
+
+// @brief Writes anything left and closes the log
+// @details Prints how big the log ended up, so the size of a real match can be checked from the terminal
+void recorder_stop() {
+    if (recorder_file == nullptr) {return;}
+    recorder_flush();
+    startup_sd_mutex.take();
+    fclose(recorder_file);
+    startup_sd_mutex.give();
+    recorder_file = nullptr;
+    uint32_t seconds = (pros::millis() - recorder_start_ms) / 1000;
+    printf("recorder: closed log, %lu KB over %lus\n", (unsigned long)(recorder_bytes / 1024), (unsigned long)seconds);
+}
+
+// @brief Opens or closes the log if another task asked to
+// @details Only the telemetry task calls this, between draining frames, so a log is never closed mid write.
+// The SD card is shared with the startup jobs and the calibration file, so startup_sd_mutex is held for every
+// open, write and close.
+void recorder_service() {
+    if (recorder_stop_pending.exchange(false)) {recorder_stop();}
+    if (recorder_start_pending.exchange(false) && recorder_file == nullptr) {
+        startup_sd_mutex.take();
+        recorder_start();
+        startup_sd_mutex.give();
+    }
+}
+#pragma endregion
@@ -0,0 +1,48 @@
+#include "startup.hpp"
+#include "main.h"
+
+// ** @file startup.cpp
+// ** @brief This file contains the background startup jobs.
+// ** @details Each job is a one-off task. When the last one finishes, how long startup took is printed to the terminal.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region jobs
+// @brief Waits for a job to finish
+// @param timeout_ms The longest to wait, 0 to only check
+// @return True if the job finished and succeeded
+bool startup_job::wait(uint32_t timeout_ms) const {
+    uint32_t start = pros::millis();
+    while (!ready.load(std::memory_order_acquire) && pros::millis() - start < timeout_ms) {pros::delay(ez::util::DELAY_TIME);}
+    return ready.load(std::memory_order_acquire) && ok;
+}
+
+// @brief Marks the start of startup, every job's time is measured from here
+// @param jobs How many jobs will be started, the report is printed when that many have finished
+void startup_begin(int jobs) {
+    startup_begin_ms = pros::millis();
+    startup_remaining = jobs;
+}
+
+// @brief Runs a job in its own task
+// @param job The job's ready flag
+// @param fn The work to do, returns true if it succeeded
+void startup_run(startup_job& job, std::function<bool()> fn) {
+    pros::Task([&job, fn]() {
+        job.ok = fn();
+        job.done_ms = pros::millis() - startup_begin_ms;
+        job.ready.store(true, std::memory_order_release);
+        if (--startup_remaining == 0) {startup_report();}
+    }, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, job.name);
+}
+
+// @brief Prints how long each job took and when the robot was ready
+void startup_report() {
+    uint32_t ready_ms = 0;
+    for (startup_job* job : {&startup_imu, &startup_curve, &startup_selector}) {
+        if (!job->ready) {continue;}
+        printf("startup: %-8s %5lums %s\n", job->name, (unsigned long)job->done_ms, job->ok ? "ok" : "FAILED");
+        if (job->done_ms > ready_ms) {ready_ms = job->done_ms;}
+    }
+    printf("startup: ready %lums after initialize()\n", (unsigned long)ready_ms);
+}
+#pragma endregion
@@ -0,0 +1,114 @@
+#include "telemetry.hpp"
+#include "main.h"
+#include "pros/rtos.hpp"
+
+// ** @file telemetry.cpp
+// ** @brief This file contains the PID telemetry recorder and the task that drains it.
+// ** @details This replaces pid_print_toggle for watching PIDs live, which printed from inside the control loop.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region recording
+// @brief Reads a tracking wheel's rotation sensor
+// @param sensor The rotation sensor to read
+// @return The distance the wheel has travelled in inches, or 0 if the sensor isn't plugged in
+static float tracker_inches(pros::Rotation& sensor) {
+    int32_t centidegrees = sensor.get_position();
+    if (centidegrees == PROS_ERR) {return 0.0f;}
+    return centidegrees / 36000.0 * M_PI * ODOM_DIAMETER;
+}
+
+// @brief Copies one PID's internals into a snapshot
+// @param pid The PID to copy
+// @param snapshot Where to copy it to
+static void pid_snapshot_fill(const ez::PID& pid, pid_snapshot& snapshot) {
+    snapshot.target = pid.target;
+    snapshot.cur = pid.cur;
+    snapshot.error = pid.error;
+    snapshot.output = pid.output;
+    snapshot.integral = pid.integral;
+    snapshot.derivative = pid.derivative;
+}
+
+// @brief Records one frame of the pose, drive and subsystem motors, and every chassis PID
+// @details This is the producer side of telemetry_ring and is registered with the executive in initialize().
+// If the consumer has fallen behind the frame is dropped and counted rather than waiting for space.
+// Motor current and voltage change slowly and cost 18 device reads, so they're only read at TELEMETRY_MOTOR_RATE.
+// The frames in between repeat the last reading, which the recorder stores as unchanged for free.
+void telemetry_record() {
+    static int16_t current_last[TELEMETRY_MOTORS] = {};
+    static int16_t voltage_last[TELEMETRY_MOTORS] = {};
+    static uint32_t frames = 0;
+
+    telemetry_frame frame;
+    frame.time = pros::micros();
+    frame.mode = chassis.drive_mode_get();
+    frame.x = chassis.odom_x_get();
+    frame.y = chassis.odom_y_get();
+    frame.theta = chassis.odom_theta_get();
+    frame.left = chassis.drive_sensor_left();
+    frame.right = chassis.drive_sensor_right();
+    frame.vert = tracker_inches(odom_vert);
+    frame.horiz = tracker_inches(odom_horiz);
+    double rotation = imu.get_rotation();
+    frame.imu = rotation == PROS_ERR_F ? 0.0f : rotation;
+
+    if (frames++ % (TELEMETRY_RATE / TELEMETRY_MOTOR_RATE) == 0) {
+        int i = 0;
+        for (pros::Motor* motor : {&motor_LF, &motor_LM, &motor_LB, &motor_RF, &motor_RM, &motor_RB, &motor_intake, &motor_roller1, &motor_roller2}) {
+            int32_t current = motor->get_current_draw();
+            int32_t voltage = motor->get_voltage();
+            current_last[i] = current == PROS_ERR ? 0 : current;
+            voltage_last[i] = voltage == PROS_ERR ? 0 : voltage;
+            i++;
+        }
+    }
+    memcpy(frame.current, current_last, sizeof(current_last));
+    memcpy(frame.voltage, voltage_last, sizeof(voltage_last));
+
+    pid_snapshot_fill(chassis.turnPID, frame.pids[TLM_TURN]);
+    pid_snapshot_fill(chassis.fwd_rev_drivePID, frame.pids[TLM_DRIVE]);
+    pid_snapshot_fill(chassis.headingPID, frame.pids[TLM_HEADING]);
+    pid_snapshot_fill(chassis.fwd_rev_swingPID, frame.pids[TLM_SWING]);
+    pid_snapshot_fill(chassis.xyPID, frame.pids[TLM_XY]);
+    pid_snapshot_fill(chassis.odom_angularPID, frame.pids[TLM_ODOM_ANGULAR]);
+    pid_snapshot_fill(chassis.boomerangPID, frame.pids[TLM_BOOMERANG]);
+
+    if (!telemetry_ring.push(frame)) {telemetry_dropped++;}
+}
+#pragma endregion
+
+#pragma region draining
+// @brief Enables or disables printing telemetry frames to the terminal
+// @param toggle True to print every frame as a CSV line
+void telemetry_print_toggle(bool toggle) {
+    if (toggle && !telemetry_print) {
+        printf("time_us,mode");
+        for (const char* name : {"turn", "drive", "heading", "swing", "xy", "odom_ang", "boomerang"}) {
+            printf(",%s_target,%s_cur,%s_error,%s_output,%s_i,%s_d", name, name, name, name, name, name);
+        }
+        printf("\n");
+    }
+    telemetry_print = toggle;
+}
+
+// @brief Drains the telemetry ring
+// @details This is the consumer side of telemetry_ring and runs at the lowest priority so it only uses
+// time the control tasks leave over. Every frame is handed to the SD card recorder, and printed if enabled.
+// Opening and closing the log happens here too, so only this task ever touches the recorder.
+void telemetry_t() {
+    telemetry_frame frame;
+    while (true) {
+        while (telemetry_ring.pop(frame)) {
+            recorder_write(frame);
+            if (!telemetry_print) {continue;}
+            printf("%llu,%u", (unsigned long long)frame.time, frame.mode);
+            for (const pid_snapshot& pid : frame.pids) {
+                printf(",%.3f,%.3f,%.3f,%.3f,%.3f,%.3f", pid.target, pid.cur, pid.error, pid.output, pid.integral, pid.derivative);
+            }
+            printf("\n");
+        }
+        recorder_service();  // After draining, so a log being closed gets every frame up to now
+        pros::delay(ez::util::DELAY_TIME * 2);
+    }
+}
+#pragma endregion
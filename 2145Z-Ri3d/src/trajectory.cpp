@@ -0,0 +1,143 @@
+#include "trajectory.hpp"
+#include "main.h"
+#include "trajectory_squiggles.hpp"
+
+// ** @file trajectory.cpp
+// ** @brief This file contains the trajectory follower.
+// ** @details Trajectories come from squiggles, either as flash tables in trajectories.hpp or generated on the brain in
+// initialize() with trajectory_generate(). While one is running the chassis is put in DISABLE so EZ-Template's
+// PID task leaves the motors alone.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region generation
+// @brief Generates a trajectory on the brain with squiggles
+// @param waypoints Poses to pass through, theta is the heading the robot has at each one
+// @param max_vel Max velocity in in/s
+// @param max_accel Max acceleration in in/s^2
+// @param max_jerk Max jerk in in/s^3
+// @param reversed True to drive the path backwards, waypoint headings are still the way the front faces
+// @return The trajectory, it stays valid for the rest of the program
+// @note This takes a while, only call it from initialize(). Tables from tools/gen_trajectory.cpp cost nothing.
+trajectory trajectory_generate(std::vector<ez::pose> waypoints, double max_vel, double max_accel, double max_jerk, bool reversed) {
+    std::vector<squiggles::Pose> poses;
+    for (const ez::pose& waypoint : waypoints) {
+        poses.push_back(trajectory_waypoint(waypoint.x, waypoint.y, waypoint.theta + (reversed ? 180.0 : 0.0)));
+    }
+    squiggles::Constraints constraints(max_vel, max_accel, max_jerk);
+    squiggles::SplineGenerator generator(constraints, std::make_shared<squiggles::TankModel>(DRIVE_WIDTH, constraints),
+                                         ez::util::DELAY_TIME / 1000.0);
+    traj_generated.push_back(trajectory_from_profile(generator.generate(poses), reversed));
+    return {traj_generated.back().data(), traj_generated.back().size()};
+}
+#pragma endregion
+
+#pragma region following
+// @brief Starts following a trajectory
+// @param traj The trajectory to follow, it should start near where the robot is
+// @param controller How to correct with odometry, RAMSETE unless told otherwise
+void pid_trajectory_set(trajectory traj, traj_controller controller) {
+    if (traj.points == nullptr || traj.size == 0) {return;}
+
+    // The executive can run between any of these, so it mustn't see a new trajectory with the old index
+    traj_running = false;
+    chassis.drive_mode_set(ez::DISABLE);
+    profile_running = false;  // Every follower drives the chassis in DISABLE, only one can have it
+    pursuit_running = false;
+    traj_active = traj;
+    traj_controller_active = controller;
+    traj_index = 0;
+    traj_start_time = pros::millis();
+    traj_running = true;  // Last, once everything above is in place
+}
+
+// @brief Waits until the current trajectory has finished
+void trajectory_wait() {
+    while (traj_running) {pros::delay(ez::util::DELAY_TIME);}
+}
+
+// @brief Stops following the current trajectory and stops the drive
+void trajectory_stop() {
+    if (!traj_running) {return;}
+    traj_running = false;
+    chassis.drive_set(0, 0);
+}
+
+// @brief Converts a wheel velocity and acceleration to a drive_set output
+// @param k The side's constants, traj_k.left or traj_k.right
+// @param vel Wheel velocity in in/s
+// @param accel Wheel acceleration in in/s^2
+// @details kS, kV and kA are for a battery at BATTERY_NOMINAL, the output is scaled for the one in the robot.
+// The profiled drive uses this too, so both followers share one set of drive constants.
+double trajectory_feedforward(const ff_gains& k, double vel, double accel) {
+    double output = k.kV * vel + k.kA * accel;
+    if (fabs(vel) > 0.1) {output += k.kS * ez::util::sgn(vel);}
+    return battery_apply(battery_scale_get(), output, 127.0);
+}
+
+// @brief Gets how far out the wheels act like they are when turning
+// @return Inches of wheel travel per radian of heading
+// @details Tank drives scrub when they turn, so they take more wheel travel per degree than DRIVE_WIDTH says.
+// The angular kV is what a degree per second really costs, and dividing it by the linear kV turns it back into
+// wheel travel. It's DRIVE_WIDTH / 2 until measure_feedforward() has been run.
+double trajectory_turn_radius() {
+    double kV = (traj_k.left.kV + traj_k.right.kV) / 2.0;
+    if (kV <= 0.0 || traj_k.angular.kV <= 0.0) {return DRIVE_WIDTH / 2.0;}
+    return traj_k.angular.kV / ez::util::to_rad(kV);
+}
+
+// @brief Runs one iteration of the trajectory follower
+// @note This is registered with the executive in initialize()
+void trajectory_iterate() {
+    if (!traj_running) {return;}
+
+    // Someone else started a motion, let it have the drive
+    if (chassis.drive_mode_get() != ez::DISABLE) {
+        traj_running = false;
+        return;
+    }
+
+    // Find the reference for this tick, time only moves forward so the search carries on from last tick
+    double t = (pros::millis() - traj_start_time) / 1000.0;
+    while (traj_index + 1 < traj_active.size && traj_active.points[traj_index + 1].time <= t) {traj_index++;}
+    if (t > traj_active.points[traj_active.size - 1].time) {
+        trajectory_stop();
+        return;
+    }
+    const traj_point& ref = traj_active.points[traj_index];
+
+    // Error in the robot's frame
+    ez::pose current = odom_fast_get();
+    double heading = ez::util::to_rad(current.theta);
+    double dx = ref.x - current.x;
+    double dy = ref.y - current.y;
+    double error_along = dx * sin(heading) + dy * cos(heading);
+    double error_cross = dx * cos(heading) - dy * sin(heading);
+    double error_theta = ez::util::wrap_angle(ref.theta - current.theta);
+
+    // The velocity and turn rate the trajectory wants plus odometry feedback
+    double vel, omega;
+    if (traj_controller_active == TRAJ_RAMSETE) {
+        ramsete_command command = ramsete(ramsete_k, ref.vel, ref.omega, error_along, error_cross, error_theta);
+        vel = command.vel;
+        omega = command.omega;
+    } else {
+        vel = ref.vel + traj_k.k_along * error_along;
+        omega = ref.omega + traj_k.k_cross * error_cross * (ref.vel >= 0 ? 1.0 : -1.0) + traj_k.k_theta * error_theta;
+    }
+
+    // Trajectories don't store angular acceleration, the change in turn rate to the next point is close enough.
+    // Without it the robot's heading lags the whole way through every turn.
+    double alpha = 0.0;
+    if (traj_index + 1 < traj_active.size) {
+        const traj_point& next = traj_active.points[traj_index + 1];
+        if (next.time > ref.time) {alpha = (next.omega - ref.omega) / (next.time - ref.time);}
+    }
+
+    // Feedforward for each side
+    double turn = ez::util::to_rad(omega) * trajectory_turn_radius();
+    double spin = battery_apply(battery_scale_get(), traj_k.angular.kA * alpha, 127.0);
+    double left = trajectory_feedforward(traj_k.left, vel + turn, ref.accel) + spin;
+    double right = trajectory_feedforward(traj_k.right, vel - turn, ref.accel) - spin;
+    chassis.drive_set(ez::util::clamp(left, 127.0), ez::util::clamp(right, 127.0));
+}
+#pragma endregion
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "../include/battery_comp.hpp"
+
+// ** @file battery_sim.cpp
+// ** @brief Runs a drive PID on a simulated drive with a sagging battery, with and without battery compensation.
+// ** @details This isn't part of the robot build. Compile it on its own:
+//   g++ -std=c++17 -O2 -o battery_sim tools/battery_sim.cpp
+// Usage:
+//   battery_sim [--distance in] [--speed n] [--resistance ohms]
+// The drive is EZ-Template's drive PID with the constants from default_constants(), driving a drive that has the
+// free speed of a 450rpm 3.25" drive at 12V. The battery's voltage drops by its internal resistance times the
+// current the motors pull, so it sags hardest while accelerating. Each battery is run with compensation off and on,
+// and the table shows how long each took to settle. Returns 1 if compensation made the spread of settle times
+// between batteries worse.
+// ** @author Ansh Rao - 2145Z
+
+// Defining simulation constants
+#define SIM_TICK 0.01           // s, EZ-Template's PID runs every 10ms
+#define SIM_STEP 0.001          // s, physics step
+#define SIM_FREE_SPEED 76.6     // in/s at 12V
+#define SIM_TIME_CONSTANT 0.25  // s for the drive to reach speed
+#define SIM_STALL_CURRENT 24.0  // A all six motors pull stalled at 12V, before the current limit
+#define SIM_CURRENT_LIMIT 15.0  // A, 2.5A a motor
+#define SIM_FRICTION 1.5        // A to keep the drive rolling
+#define SIM_KP 20.0             // default_constants() drive PID
+#define SIM_KD 100.0
+#define SIM_SETTLE_ERROR 1.0    // in, EZ-Template's small exit
+#define SIM_SETTLE_TIME 0.09    // s
+#define SIM_TIMEOUT 4.0         // s
+
+// declaring sim options struct
+struct sim_options {
+    double distance = 24.0;    // in
+    double speed = 110.0;      // drive_set max speed, DRIVE_SPEED
+    double resistance = 0.12;  // ohms of battery internal resistance
+};
+
+// @brief Parses command line options
+// @return False if an option wasn't recognised
+static bool sim_options_parse(int argc, char** argv, sim_options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--distance" && has_value) {options.distance = atof(argv[++i]);}
+        else if (arg == "--speed" && has_value) {options.speed = atof(argv[++i]);}
+        else if (arg == "--resistance" && has_value) {options.resistance = atof(argv[++i]);}
+        else {return false;}
+    }
+    return true;
+}
+
+// declaring sim result struct
+struct sim_result {
+    double settle = SIM_TIMEOUT;  // s
+    double overshoot = 0.0;       // in
+    double lowest = 0.0;          // V the battery sagged to
+};
+
+// @brief Drives one move
+// @param open_circuit The battery's voltage with nothing pulling on it, in V
+// @param compensate True to scale the PID's output with battery_comp
+static sim_result sim_drive(const sim_options& options, double open_circuit, bool compensate) {
+    battery_comp battery;
+    sim_result result;
+    result.lowest = open_circuit;
+    double position = 0.0, velocity = 0.0, current = 0.0, voltage = open_circuit;
+    double error_last = options.distance, settled_for = 0.0, output = 0.0;
+
+    for (double t = 0.0; t < SIM_TIMEOUT; t += SIM_STEP) {
+        // The PID and battery filter run every tick, like the executive
+        if (std::fmod(t + SIM_STEP / 2.0, SIM_TICK) < SIM_STEP) {
+            battery_filter(battery, voltage * 1000.0, SIM_TICK);
+            double error = options.distance - position;
+            double pid = std::clamp(SIM_KP * error + SIM_KD * (error - error_last), -options.speed, options.speed);
+            error_last = error;
+            // On the robot the gains and the speed cap are scaled, which is the same as scaling the output
+            output = compensate ? battery_apply(battery_scale(battery), pid, 127.0) : pid;
+
+            settled_for = std::fabs(error) < SIM_SETTLE_ERROR ? settled_for + SIM_TICK : 0.0;
+            if (settled_for >= SIM_SETTLE_TIME) {
+                result.settle = t;
+                break;
+            }
+        }
+
+        // The motors get a fraction of whatever the battery has right now
+        double applied = output / 127.0 * voltage;
+        double wanted = SIM_STALL_CURRENT * (applied / 12.0 - velocity / SIM_FREE_SPEED);
+        current = std::clamp(wanted, -SIM_CURRENT_LIMIT, SIM_CURRENT_LIMIT);
+        double friction = velocity > 0.0 ? SIM_FRICTION : velocity < 0.0 ? -SIM_FRICTION : 0.0;
+        velocity += (current - friction) * SIM_FREE_SPEED / (SIM_STALL_CURRENT * SIM_TIME_CONSTANT) * SIM_STEP;
+        position += velocity * SIM_STEP;
+        voltage = open_circuit - std::fabs(current) * options.resistance;
+        result.lowest = std::min(result.lowest, voltage);
+        result.overshoot = std::max(result.overshoot, position - options.distance);
+    }
+    return result;
+}
+
+int main(int argc, char** argv) {
+    sim_options options;
+    if (!sim_options_parse(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--distance in] [--speed n] [--resistance ohms]\n", argv[0]);
+        return 2;
+    }
+
+    const double batteries[] = {12.2, 12.6, 13.0};
+    double spread[2] = {0.0, 0.0};
+    printf("%.0f in at speed %.0f, battery resistance %.2f ohms\n", options.distance, options.speed, options.resistance);
+    printf("battery   comp   settle   overshoot   sagged to\n");
+    for (int compensate = 0; compensate < 2; compensate++) {
+        double fastest = SIM_TIMEOUT, slowest = 0.0;
+        for (double open_circuit : batteries) {
+            sim_result result = sim_drive(options, open_circuit, compensate);
+            printf("%5.1fV   %-4s   %5.0fms   %7.2fin   %7.2fV\n", open_circuit, compensate ? "on" : "off", result.settle * 1000.0,
+                   result.overshoot, result.lowest);
+            fastest = std::min(fastest, result.settle);
+            slowest = std::max(slowest, result.settle);
+        }
+        spread[compensate] = slowest - fastest;
+    }
+    printf("settle time spread across batteries: %.0fms off, %.0fms on\n", spread[0] * 1000.0, spread[1] * 1000.0);
+    return spread[1] > spread[0] ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/ff_fit.hpp"
+
+// ** @file ff_sim.cpp
+// ** @brief Runs measure_feedforward()'s tests on a simulated drive and checks the fit finds its constants.
+// ** @details This isn't part of the robot build. Compile it on its own:
+//   g++ -std=c++17 -O2 -o ff_sim tools/ff_sim.cpp
+// Usage:
+//   ff_sim [--noise in] [--span n] [--seed n]
+// Each side of the drive has the free speed of a 450rpm 3.25" drive and its own friction, and turning on the spot
+// scrubs, so it takes more output and a wider track than DRIVE_WIDTH says. Encoders read in whole ticks, plus
+// --noise inches of gaussian noise. The tests are the ramps and steps from characterize.hpp, fit with ff_fit.hpp.
+// Returns 1 if any kV or kA is more than 10% off, or any kS more than 1 output.
+// ** @author Ansh Rao - 2145Z
+
+// Defining simulation constants
+#define SIM_TICK 0.01             // s, samples are recorded every 10ms
+#define SIM_STEP 0.001            // s, physics step
+#define SIM_FREE_SPEED 76.6       // in/s at 12V
+#define SIM_TIME_CONSTANT 0.25    // s for the drive to reach speed
+#define SIM_STALL_CURRENT 24.0    // A all six motors pull stalled at 12V, before the current limit
+#define SIM_CURRENT_LIMIT 15.0    // A, 2.5A a motor
+#define SIM_FRICTION_LEFT 1.5     // A to keep each side rolling
+#define SIM_FRICTION_RIGHT 1.9
+#define SIM_SCRUB 1.5             // A more while turning on the spot
+#define SIM_TURN_RADIUS 7.0       // in, DRIVE_WIDTH / 2 is 6 but the wheels scrub
+#define SIM_TICK_SIZE 0.0255      // in per encoder tick, 300 ticks a motor rev geared 600:450 on 3.25" wheels
+#define SIM_IMU_RESOLUTION 0.01   // deg
+
+// Defining the tests from characterize.hpp
+#define FF_RAMP_RATE 24.0
+#define FF_RAMP_TIME 2.5
+#define FF_STEP_OUTPUT 70.0
+#define FF_STEP_TIME 0.5
+
+// declaring sim options struct
+struct sim_options {
+    double noise = 0.0;  // in of gaussian noise on each encoder reading
+    size_t span = 3;     // FF_SPAN
+    unsigned seed = 1;
+};
+
+// @brief Parses command line options
+// @return False if an option wasn't recognised
+static bool sim_options_parse(int argc, char** argv, sim_options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--noise" && has_value) {options.noise = atof(argv[++i]);}
+        else if (arg == "--span" && has_value) {options.span = atoi(argv[++i]);}
+        else if (arg == "--seed" && has_value) {options.seed = atoi(argv[++i]);}
+        else {return false;}
+    }
+    return true;
+}
+
+// declaring sim side struct
+// - one side of the drive, stopped by friction once it slows right down
+struct sim_side {
+    double position = 0.0;  // in
+    double velocity = 0.0;  // in/s
+
+    // @brief Moves the side one physics step with a drive_set output
+    void step(double output, double friction) {
+        double wanted = SIM_STALL_CURRENT * (output / 127.0 - velocity / SIM_FREE_SPEED);
+        double current = std::clamp(wanted, -SIM_CURRENT_LIMIT, SIM_CURRENT_LIMIT);
+        if (velocity == 0.0 && std::fabs(current) <= friction) {return;}
+        double sign = velocity != 0.0 ? (velocity > 0.0 ? 1.0 : -1.0) : (current > 0.0 ? 1.0 : -1.0);
+        double next = velocity + (current - friction * sign) * SIM_FREE_SPEED / (SIM_STALL_CURRENT * SIM_TIME_CONSTANT) * SIM_STEP;
+        velocity = next * velocity < 0.0 ? 0.0 : next;
+        position += velocity * SIM_STEP;
+    }
+};
+
+// declaring sim fits struct
+struct sim_fits {
+    ff_fit left, right, angular;
+    double furthest = 0.0;  // in the straight tests got from the start
+};
+
+// @brief Runs one test like ff_test() in characterize.cpp and adds it to the fits
+// @param turn True to turn on the spot, false to drive straight
+// @param start Output at the start of the test
+// @param rate Output per second to ramp by
+// @param time s to run for
+static void sim_test(sim_fits& fits, const sim_options& options, std::mt19937& rng, bool turn, double start, double rate, double time) {
+    std::normal_distribution<double> noise(0.0, options.noise > 0.0 ? options.noise : 1e-12);
+    sim_side left, right;
+    std::vector<double> left_pos, right_pos, heading, output;
+    for (int tick = 0; tick * SIM_TICK < time; tick++) {
+        double out = start + rate * tick * SIM_TICK;
+        double left_read = std::round(left.position / SIM_TICK_SIZE) * SIM_TICK_SIZE + noise(rng);
+        double right_read = std::round(right.position / SIM_TICK_SIZE) * SIM_TICK_SIZE + noise(rng);
+        double theta = (left.position - right.position) / 2.0 / SIM_TURN_RADIUS * 180.0 / M_PI;
+        left_pos.push_back(left_read);
+        right_pos.push_back(right_read);
+        heading.push_back(std::round(theta / SIM_IMU_RESOLUTION) * SIM_IMU_RESOLUTION);
+        output.push_back(out);
+        fits.furthest = std::max(fits.furthest, std::fabs(turn ? 0.0 : left.position));
+        for (int i = 0; i < SIM_TICK / SIM_STEP; i++) {
+            left.step(out, SIM_FRICTION_LEFT + (turn ? SIM_SCRUB : 0.0));
+            right.step(turn ? -out : out, SIM_FRICTION_RIGHT + (turn ? SIM_SCRUB : 0.0));
+        }
+    }
+    if (turn) {ff_fit_series(fits.angular, heading, output, SIM_TICK, options.span);}
+    else {
+        ff_fit_series(fits.left, left_pos, output, SIM_TICK, options.span);
+        ff_fit_series(fits.right, right_pos, output, SIM_TICK, options.span);
+    }
+}
+
+// @brief Prints one fit next to the constants it should have found
+// @return True if it's close enough
+static bool sim_report(const char* name, const ff_fit& fit, const ff_gains& truth) {
+    ff_gains gains;
+    double r2 = 0.0;
+    if (!ff_fit_solve(fit, gains, r2)) {
+        printf("%-8s  didn't solve (%i samples)\n", name, fit.samples);
+        return false;
+    }
+    printf("%-8s  kS %6.3f (%6.3f)   kV %7.4f (%7.4f)   kA %7.4f (%7.4f)   r2 %.4f   %i samples\n", name, gains.kS, truth.kS,
+           gains.kV, truth.kV, gains.kA, truth.kA, r2, fit.samples);
+    return std::fabs(gains.kS - truth.kS) <= 1.0 && std::fabs(gains.kV / truth.kV - 1.0) <= 0.1 && std::fabs(gains.kA / truth.kA - 1.0) <= 0.1;
+}
+
+int main(int argc, char** argv) {
+    sim_options options;
+    if (!sim_options_parse(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--noise in] [--span n] [--seed n]\n", argv[0]);
+        return 2;
+    }
+
+    std::mt19937 rng(options.seed);
+    sim_fits fits;
+    for (double direction : {1.0, -1.0}) {
+        sim_test(fits, options, rng, false, 0.0, FF_RAMP_RATE * direction, FF_RAMP_TIME);
+        sim_test(fits, options, rng, false, FF_STEP_OUTPUT * direction, 0.0, FF_STEP_TIME);
+        sim_test(fits, options, rng, true, 0.0, FF_RAMP_RATE * direction, FF_RAMP_TIME);
+        sim_test(fits, options, rng, true, FF_STEP_OUTPUT * direction, 0.0, FF_STEP_TIME);
+    }
+
+    // What the model's constants are in drive_set output, angular ones per deg of heading
+    const double kV = 127.0 / SIM_FREE_SPEED, kA = 127.0 * SIM_TIME_CONSTANT / SIM_FREE_SPEED;
+    const double per_deg = SIM_TURN_RADIUS * M_PI / 180.0;
+    const ff_gains left = {SIM_FRICTION_LEFT / SIM_STALL_CURRENT * 127.0, kV, kA};
+    const ff_gains right = {SIM_FRICTION_RIGHT / SIM_STALL_CURRENT * 127.0, kV, kA};
+    const double turn_kS = ((SIM_FRICTION_LEFT + SIM_FRICTION_RIGHT) / 2.0 + SIM_SCRUB) / SIM_STALL_CURRENT * 127.0;
+    const ff_gains angular = {turn_kS, kV * per_deg, kA * per_deg};
+
+    printf("noise %.3fin, span %zu, furthest %.1fin from the start (found, actual)\n", options.noise, options.span, fits.furthest);
+    bool ok = sim_report("left", fits.left, left);
+    ok = sim_report("right", fits.right, right) && ok;
+    ok = sim_report("angular", fits.angular, angular) && ok;
+    return ok ? 0 : 1;
+}
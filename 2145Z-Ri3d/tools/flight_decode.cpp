@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#include "flight_log_read.hpp"
+
+// ** @file flight_decode.cpp
+// ** @brief Decodes SD card flight logs (/usd/flNNN.bin) on a laptop.
+// ** @details This isn't part of the robot build. Compile it on its own:
+//   g++ -std=c++17 -O2 -o flight_decode tools/flight_decode.cpp
+// Usage:
+//   flight_decode fl000.bin                 CSV to stdout
+//   flight_decode fl000.bin --csv out.csv   CSV to a file
+//   flight_decode fl000.bin --columns dir   one little endian float64 file per channel plus dir/schema.csv
+// ** @author Ansh Rao - 2145Z
+
+#pragma region writing
+// @brief Writes every record as one CSV row
+static void flight_log_csv(const flight_log& log, FILE* out) {
+    for (size_t c = 0; c < log.names.size(); c++) {fprintf(out, "%s%s", c ? "," : "", log.names[c].c_str());}
+    fprintf(out, "\n");
+    size_t rows = log.columns.empty() ? 0 : log.columns[0].size();
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < log.columns.size(); c++) {fprintf(out, "%s%.10g", c ? "," : "", log.columns[c][r]);}
+        fprintf(out, "\n");
+    }
+}
+
+// @brief Writes each channel to its own raw float64 file, with a schema listing them
+static std::string flight_log_columns(const flight_log& log, const std::string& dir) {
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    if (error) {return "can't create " + dir;}
+
+    FILE* schema = fopen((dir + "/schema.csv").c_str(), "w");
+    if (schema == nullptr) {return "can't write " + dir + "/schema.csv";}
+    fprintf(schema, "name,file,type,rows,scale\n");
+    for (size_t c = 0; c < log.names.size(); c++) {
+        std::string file = log.names[c] + ".f64";
+        FILE* out = fopen((dir + "/" + file).c_str(), "wb");
+        if (out == nullptr) {
+            fclose(schema);
+            return "can't write " + dir + "/" + file;
+        }
+        fwrite(log.columns[c].data(), sizeof(double), log.columns[c].size(), out);
+        fclose(out);
+        fprintf(schema, "%s,%s,float64le,%zu,%g\n", log.names[c].c_str(), file.c_str(), log.columns[c].size(), log.scales[c]);
+    }
+    fclose(schema);
+    return "";
+}
+#pragma endregion
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 4) {
+        fprintf(stderr, "usage: %s <log.bin> [--csv out.csv | --columns dir]\n", argv[0]);
+        return 2;
+    }
+
+    flight_log log;
+    std::string error = flight_log_read(argv[1], log);
+    if (!error.empty()) {
+        fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+        return 1;
+    }
+    size_t rows = log.columns.empty() ? 0 : log.columns[0].size();
+    fprintf(stderr, "%s: v%i, %zu channels, %zu records in %zu blocks%s\n", argv[1], log.version, log.names.size(), rows, log.blocks,
+            log.truncated ? " (last block truncated)" : "");
+
+    if (argc == 2) {
+        flight_log_csv(log, stdout);
+    } else if (strcmp(argv[2], "--csv") == 0) {
+        FILE* out = fopen(argv[3], "w");
+        if (out == nullptr) {
+            fprintf(stderr, "can't write %s\n", argv[3]);
+            return 1;
+        }
+        flight_log_csv(log, out);
+        fclose(out);
+    } else if (strcmp(argv[2], "--columns") == 0) {
+        error = flight_log_columns(log, argv[3]);
+        if (!error.empty()) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    } else {
+        fprintf(stderr, "unknown option %s\n", argv[2]);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../include/flight_log.hpp"
+
+// ** @file flight_log_read.hpp
+// ** @brief Reads SD card flight logs back into columns, shared by the tools in this folder.
+// ** @author Ansh Rao - 2145Z
+
+#pragma region reading
+// declaring decoded log struct
+struct flight_log {
+    int version = 0;
+    std::vector<std::string> names;
+    std::vector<float> scales;
+    std::vector<std::vector<double>> columns;  // columns[channel][record]
+    size_t blocks = 0;
+    bool truncated = false;
+};
+
+// @brief Reads and decodes a whole log file
+// @param path The file to read
+// @param log Where to put the decoded channels
+// @return An error message, or an empty string on success
+inline std::string flight_log_read(const char* path, flight_log& log) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {return std::string("can't open ") + path;}
+    std::vector<uint8_t> data;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {data.insert(data.end(), chunk, chunk + n);}
+    fclose(file);
+
+    const uint8_t* p = data.data();
+    const uint8_t* end = p + data.size();
+    if (data.size() < 11 || memcmp(p, FLIGHT_LOG_MAGIC, 8) != 0) {return "not a flight log";}
+    log.version = p[8];
+    if (log.version != FLIGHT_LOG_VERSION) {return "unsupported version " + std::to_string(log.version);}
+    size_t channels = flight_log_u16_get(p + 9);
+    if (channels == 0 || channels > FLIGHT_LOG_MAX_CHANNELS) {return "bad channel count";}
+    p += 11;
+
+    for (size_t i = 0; i < channels; i++) {
+        if (p >= end || p + 1 + *p + sizeof(float) > end) {return "truncated header";}
+        size_t length = *p++;
+        log.names.emplace_back((const char*)p, length);
+        p += length;
+        float scale;
+        memcpy(&scale, p, sizeof(float));
+        log.scales.push_back(scale != 0.0f ? scale : 1.0f);
+        p += sizeof(float);
+    }
+    log.columns.resize(channels);
+
+    const size_t mask_len = (channels + 7) / 8;
+    std::vector<int32_t> prev(channels);
+    while (p + 5 <= end) {
+        if (p[0] != 'B') {return "bad block marker after " + std::to_string(log.blocks) + " blocks";}
+        size_t length = flight_log_u16_get(p + 1);
+        size_t records = flight_log_u16_get(p + 3);
+        p += 5;
+        if (p + length > end) {
+            log.truncated = true;
+            break;
+        }
+        const uint8_t* block_end = p + length;
+        std::fill(prev.begin(), prev.end(), 0);
+
+        for (size_t r = 0; r < records; r++) {
+            if (p + mask_len > block_end) {return "corrupt block " + std::to_string(log.blocks);}
+            const uint8_t* mask = p;
+            p += mask_len;
+            for (size_t c = 0; c < channels; c++) {
+                if (mask[c / 8] & (1 << (c % 8))) {
+                    uint32_t raw;
+                    size_t used = flight_log_varint_get(p, block_end, raw);
+                    if (used == 0) {return "corrupt block " + std::to_string(log.blocks);}
+                    p += used;
+                    prev[c] += flight_log_unzigzag(raw);
+                }
+                log.columns[c].push_back(prev[c] / (double)log.scales[c]);
+            }
+        }
+        p = block_end;
+        log.blocks++;
+    }
+    if (p != end && !log.truncated) {log.truncated = true;}
+    return "";
+}
+#pragma endregion
+
+// @brief Finds a channel by name
+// @return The channel's index, or -1 if the log doesn't have it
+inline int flight_log_channel(const flight_log& log, const std::string& name) {
+    for (size_t c = 0; c < log.names.size(); c++) {
+        if (log.names[c] == name) {return c;}
+    }
+    return -1;
+}
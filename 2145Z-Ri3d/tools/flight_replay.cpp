@@ -0,0 +1,133 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "../include/odom_math.hpp"
+#include "flight_log_read.hpp"
+
+// ** @file flight_replay.cpp
+// ** @brief Re-runs odometry against the raw sensors in an SD card flight log and diffs it against the logged pose.
+// ** @details This isn't part of the robot build. Compile it on its own:
+//   g++ -std=c++17 -O2 -o flight_replay tools/flight_replay.cpp
+// Usage:
+//   flight_replay fl000.bin [--trackers] [--vert-offset in] [--horiz-offset in] [--imu-scale s] [--csv out.csv]
+// By default the parallel "tracker" is the average of the drive encoders, which is what the chassis uses while
+// no tracking wheels are attached. --trackers replays the rotation sensor tracking wheels instead.
+// The integrator is odom_math.hpp, the same file the robot uses, so changes to it can be checked against old matches.
+// ** @author Ansh Rao - 2145Z
+
+// If the pose or a sensor jumps by more than this in one record, it was reset on the robot and replay starts over there
+#define REPLAY_RESET_JUMP 6.0
+
+// declaring replay options struct
+struct replay_options {
+    bool trackers = false;
+    double vert_offset = 0.0;
+    double horiz_offset = 0.0;
+    double imu_scale = 1.0;
+    const char* csv = nullptr;
+};
+
+// @brief Parses command line options
+// @return False if an option wasn't recognised
+static bool replay_options_parse(int argc, char** argv, replay_options& options) {
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--trackers") {options.trackers = true;}
+        else if (arg == "--vert-offset" && has_value) {options.vert_offset = atof(argv[++i]);}
+        else if (arg == "--horiz-offset" && has_value) {options.horiz_offset = atof(argv[++i]);}
+        else if (arg == "--imu-scale" && has_value) {options.imu_scale = atof(argv[++i]);}
+        else if (arg == "--csv" && has_value) {options.csv = argv[++i];}
+        else {return false;}
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    replay_options options;
+    if (argc < 2 || !replay_options_parse(argc, argv, options)) {
+        fprintf(stderr, "usage: %s <log.bin> [--trackers] [--vert-offset in] [--horiz-offset in] [--imu-scale s] [--csv out.csv]\n", argv[0]);
+        return 2;
+    }
+
+    flight_log log;
+    std::string error = flight_log_read(argv[1], log);
+    if (!error.empty()) {
+        fprintf(stderr, "%s: %s\n", argv[1], error.c_str());
+        return 1;
+    }
+
+    int c_time = flight_log_channel(log, "time_ms"), c_x = flight_log_channel(log, "x"), c_y = flight_log_channel(log, "y"), c_theta = flight_log_channel(log, "theta");
+    int c_left = flight_log_channel(log, "left_in"), c_right = flight_log_channel(log, "right_in");
+    int c_vert = flight_log_channel(log, "vert_in"), c_horiz = flight_log_channel(log, "horiz_in"), c_imu = flight_log_channel(log, "imu_deg");
+    for (int c : {c_time, c_x, c_y, c_theta, c_left, c_right, c_vert, c_horiz, c_imu}) {
+        if (c < 0) {
+            fprintf(stderr, "%s: log doesn't have raw sensor channels, it was recorded before replay was supported\n", argv[1]);
+            return 1;
+        }
+    }
+    auto& col = log.columns;
+    size_t rows = col[c_time].size();
+    if (rows == 0) {
+        fprintf(stderr, "%s: no records\n", argv[1]);
+        return 1;
+    }
+
+    FILE* csv = nullptr;
+    if (options.csv != nullptr) {
+        csv = fopen(options.csv, "w");
+        if (csv == nullptr) {
+            fprintf(stderr, "can't write %s\n", options.csv);
+            return 1;
+        }
+        fprintf(csv, "time_ms,x,y,theta,replay_x,replay_y,replay_theta\n");
+    }
+
+    auto vert_at = [&](size_t r) { return options.trackers ? col[c_vert][r] : (col[c_left][r] + col[c_right][r]) / 2.0; };
+    auto horiz_at = [&](size_t r) { return options.trackers ? col[c_horiz][r] : 0.0; };
+    auto heading_at = [&](size_t r) { return col[c_imu][r] * options.imu_scale; };
+
+    auto start = std::chrono::steady_clock::now();
+    odom_state state;
+    double sum_sq = 0.0, worst = 0.0, worst_theta = 0.0;
+    int resets = 0;
+    for (size_t r = 0; r < rows; r++) {
+        bool reset = r == 0;
+        if (!reset) {
+            double jump = std::max({std::fabs(col[c_x][r] - col[c_x][r - 1]), std::fabs(col[c_y][r] - col[c_y][r - 1]),
+                                    std::fabs(vert_at(r) - vert_at(r - 1)), std::fabs(horiz_at(r) - horiz_at(r - 1))});
+            reset = jump > REPLAY_RESET_JUMP;
+        }
+        if (reset) {
+            odom_reset_state(state, col[c_x][r], col[c_y][r], col[c_theta][r], vert_at(r), horiz_at(r), heading_at(r));
+            resets++;
+        } else {
+            odom_arc_step(state, vert_at(r), horiz_at(r), heading_at(r), options.vert_offset, options.horiz_offset);
+        }
+
+        double error_xy = std::hypot(state.x - col[c_x][r], state.y - col[c_y][r]);
+        double error_theta = std::fabs(std::remainder(state.theta - col[c_theta][r], 360.0));
+        sum_sq += error_xy * error_xy;
+        worst = std::max(worst, error_xy);
+        worst_theta = std::max(worst_theta, error_theta);
+        if (csv != nullptr) {
+            fprintf(csv, "%.0f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", col[c_time][r], col[c_x][r], col[c_y][r], col[c_theta][r], state.x, state.y, state.theta);
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (csv != nullptr) {fclose(csv);}
+
+    double duration = (col[c_time][rows - 1] - col[c_time][0]) / 1000.0;
+    printf("replayed %zu records (%.1f s of robot time) in %.3f ms, %.0fx real time\n", rows, duration, elapsed * 1000.0,
+           elapsed > 0.0 ? duration / elapsed : 0.0);
+    printf("source %s, %i reset%s\n", options.trackers ? "tracking wheels" : "drive encoders", resets, resets == 1 ? "" : "s");
+    printf("position error rms %.3f in, max %.3f in\n", std::sqrt(sum_sq / rows), worst);
+    printf("heading error max %.3f deg\n", worst_theta);
+    printf("final logged  (%.2f, %.2f, %.2f)\n", col[c_x][rows - 1], col[c_y][rows - 1], col[c_theta][rows - 1]);
+    printf("final replay  (%.2f, %.2f, %.2f)\n", state.x, state.y, state.theta);
+    return 0;
+}
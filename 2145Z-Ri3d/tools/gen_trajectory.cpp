@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../include/trajectory_squiggles.hpp"
+
+// ** @file gen_trajectory.cpp
+// ** @brief Generates a trajectory with squiggles and prints it as a flash table for include/trajectories.hpp.
+// ** @details This isn't part of the robot build. okapilib.a only has squiggles built for the brain, so build this
+// against the squiggles sources (the version OkapiLib 5 ships with):
+//   g++ -std=c++17 -O2 -iquote include/okapi/squiggles -o gen_trajectory tools/gen_trajectory.cpp <squiggles>/src/*.cpp
+// Usage:
+//   gen_trajectory <name> <track width> <max vel> <max accel> <max jerk> [--reversed] x,y,theta x,y,theta ...
+// Distances are inches, theta is EZ-Template degrees (0 faces +y, clockwise positive). Use the same track width as
+// DRIVE_WIDTH in subsystems.hpp.
+// ** @author Ansh Rao - 2145Z
+
+int main(int argc, char** argv) {
+    if (argc < 8) {
+        fprintf(stderr, "usage: %s <name> <track width> <max vel> <max accel> <max jerk> [--reversed] x,y,theta x,y,theta ...\n", argv[0]);
+        return 2;
+    }
+    std::string name = argv[1];
+    double width = atof(argv[2]);
+    double max_vel = atof(argv[3]);
+    double max_accel = atof(argv[4]);
+    double max_jerk = atof(argv[5]);
+
+    bool reversed = false;
+    std::vector<squiggles::Pose> poses;
+    for (int i = 6; i < argc; i++) {
+        if (strcmp(argv[i], "--reversed") == 0) {
+            reversed = true;
+            continue;
+        }
+        double x, y, theta;
+        if (sscanf(argv[i], "%lf,%lf,%lf", &x, &y, &theta) != 3) {
+            fprintf(stderr, "bad waypoint %s, expected x,y,theta\n", argv[i]);
+            return 2;
+        }
+        poses.push_back(trajectory_waypoint(x, y, theta + (reversed ? 180.0 : 0.0)));
+    }
+    if (poses.size() < 2) {
+        fprintf(stderr, "need at least two waypoints\n");
+        return 2;
+    }
+
+    squiggles::Constraints constraints(max_vel, max_accel, max_jerk);
+    squiggles::SplineGenerator generator(constraints, std::make_shared<squiggles::TankModel>(width, constraints), 0.01);
+    std::vector<traj_point> points = trajectory_from_profile(generator.generate(poses), reversed);
+    if (points.empty()) {
+        fprintf(stderr, "squiggles couldn't generate a path through those waypoints\n");
+        return 1;
+    }
+
+    printf("\n// %s: %zu points, %.2f s, max vel %g, max accel %g, max jerk %g%s\n", name.c_str(), points.size(), points.back().time, max_vel,
+           max_accel, max_jerk, reversed ? ", reversed" : "");
+    printf("inline constexpr traj_point traj_%s[] = {\n", name.c_str());
+    for (const traj_point& p : points) {
+        printf("    {%.3ff, %.3ff, %.3ff, %.3ff, %.3ff, %.3ff, %.3ff},\n", p.time, p.x, p.y, p.theta, p.vel, p.accel, p.omega);
+    }
+    printf("};\n");
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "../include/intake_jam.hpp"
+
+// ** @file intake_sim.cpp
+// ** @brief Runs the intake jam state machine against a simulated intake to check it clears jams without false alarms.
+// ** @details This isn't part of the robot build. Compile it on its own:
+//   g++ -std=c++17 -O2 -o intake_sim tools/intake_sim.cpp
+// Usage:
+//   intake_sim [--seconds n] [--seed n] [--temp C] [--jam-every s] [--hard-jams fraction]
+// The motor is a blue V5 motor with a current limit that comes down as it heats up, velocity readings lag and
+// current readings are noisy. Blocks going through load the motor, and some squeeze through hard enough to stall it
+// for a moment, which mustn't count as a jam. Jams stop the intake turning forwards until it's run backwards far
+// enough to let the block go, some need more than one reverse pulse. Hard jams never let go, the machine should give
+// up on those and the simulated driver then clears them by hand. Returns 1 if a jam wasn't cleared or given up on,
+// or the machine stopped while the motor was still turning. A hot motor can stall on an ordinary block, those are
+// counted separately since stopping is the right call.
+// ** @author Ansh Rao - 2145Z
+
+// Defining simulation constants
+#define SIM_STEP_MS 1           // physics step
+#define SIM_TICK_MS 10          // executive tick for the intake
+#define SIM_FREE_SPEED 600.0    // rpm at 12V
+#define SIM_STALL_CURRENT 4000  // mA the motor would pull stalled if nothing limited it
+#define SIM_LIMIT 2500.0        // mA current limit when cool
+#define SIM_TIME_CONSTANT 0.05  // s for the intake to reach speed
+#define SIM_FRICTION 300.0      // mA to turn the intake with nothing in it
+#define SIM_CLEAR_BY 4000       // ms a jam has to be cleared or given up on by
+#define SIM_JAM_GAP 1500        // ms after a jam before the next block can jam, any sooner looks like the same block
+
+// declaring sim options struct
+struct sim_options {
+    int seconds = 600;
+    unsigned seed = 1;
+    double temperature = 30.0;  // C the motor starts at and cools back down to
+    double jam_every = 8.0;     // s between jams on average
+    double hard_jams = 0.1;     // fraction of jams that never let go
+};
+
+// @brief Parses command line options
+// @return False if an option wasn't recognised
+static bool sim_options_parse(int argc, char** argv, sim_options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--seconds" && has_value) {options.seconds = atoi(argv[++i]);}
+        else if (arg == "--seed" && has_value) {options.seed = atoi(argv[++i]);}
+        else if (arg == "--temp" && has_value) {options.temperature = atof(argv[++i]);}
+        else if (arg == "--jam-every" && has_value) {options.jam_every = atof(argv[++i]);}
+        else if (arg == "--hard-jams" && has_value) {options.hard_jams = atof(argv[++i]);}
+        else {return false;}
+    }
+    return true;
+}
+
+// declaring sim jam struct
+struct sim_jam {
+    bool active = false;
+    bool hard = false;
+    double position = 0.0;  // degrees, the intake can't go forwards past this
+    double release = 0.0;   // degrees backwards from position that lets the block go
+    uint32_t start = 0;     // ms
+};
+
+int main(int argc, char** argv) {
+    sim_options options;
+    if (!sim_options_parse(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--seconds n] [--seed n] [--temp C] [--jam-every s] [--hard-jams fraction]\n", argv[0]);
+        return 2;
+    }
+    std::mt19937 rng(options.seed);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    intake_machine machine;
+    sim_jam jam;
+    double speed = 0.0, position = 0.0, measured_speed = 0.0, temperature = options.temperature, current = 0.0;
+    double load = 0.0;
+    uint32_t load_end = 0, driver_back = 0, jam_end = 0;
+    int voltage = 0, command = 12000;
+    int jams = 0, hard = 0, cleared = 0, locked = 0, missed = 0, false_jams = 0, block_stalls = 0, squeezes = 0;
+    uint32_t turning = 0;  // ms, when the motor was last really turning
+    uint64_t clear_total = 0;
+    uint32_t clear_worst = 0;
+    uint32_t last_jams = 0;
+
+    for (uint32_t now = 0; now < (uint32_t)options.seconds * 1000; now += SIM_STEP_MS) {
+        double dt = SIM_STEP_MS / 1000.0;
+
+        // Blocks going through load the intake for a moment, some hard enough to stall it briefly
+        if (now >= load_end) {
+            load = 0.0;
+            double roll = uniform(rng);
+            if (roll < 0.004) {
+                load = 600.0 + uniform(rng) * 1600.0;
+                load_end = now + 80 + (uint32_t)(uniform(rng) * 120.0);
+            } else if (roll < 0.0045) {
+                load = 3500.0;  // a squeeze, stalls the motor for less than stall_time
+                load_end = now + 60 + (uint32_t)(uniform(rng) * 60.0);
+                squeezes++;
+            }
+        }
+        if (!jam.active && command > 0 && now - jam_end >= SIM_JAM_GAP && uniform(rng) < dt / options.jam_every) {
+            jam = sim_jam();
+            jam.active = true;
+            jam.hard = uniform(rng) < options.hard_jams;
+            jam.position = position;
+            jam.release = 30.0 + uniform(rng) * 570.0;
+            jam.start = now;
+            jams++;
+            if (jam.hard) {hard++;}
+        }
+
+        // The motor, with its current limit coming down as it heats up
+        double limit = SIM_LIMIT * intake_current_fraction(temperature);
+        double wanted = SIM_STALL_CURRENT * (voltage / 12000.0 - speed / SIM_FREE_SPEED);
+        current = std::clamp(wanted, -limit, limit);
+        double resisting = (SIM_FRICTION + load) * (speed > 0 ? 1.0 : speed < 0 ? -1.0 : (current > 0 ? 1.0 : -1.0));
+        if (std::fabs(speed) < 1.0 && std::fabs(current) < SIM_FRICTION + load) {resisting = current;}  // Static friction holds it still
+        speed += (current - resisting) * SIM_FREE_SPEED / (SIM_STALL_CURRENT * SIM_TIME_CONSTANT) * dt;
+        position += speed * 6.0 * dt;
+        if (jam.active && position >= jam.position) {
+            position = jam.position;
+            speed = std::min(speed, 0.0);
+        }
+        if (jam.active && !jam.hard && position <= jam.position - jam.release) {
+            jam.active = false;
+            jam_end = now;
+            uint32_t took = now - jam.start;
+            cleared++;
+            clear_total += took;
+            clear_worst = std::max(clear_worst, took);
+        }
+        if (jam.active && !jam.hard && now - jam.start > SIM_CLEAR_BY) {
+            jam.active = false;  // The driver gives up and clears it by hand
+            missed++;
+        }
+        temperature += (current / 1000.0) * (current / 1000.0) * 0.05 * dt - (temperature - options.temperature) * 0.01 * dt;
+        measured_speed += (speed - measured_speed) * dt / 0.02;
+        if (std::fabs(speed) >= machine.settings.stall_velocity) {turning = now;}
+
+        if (now % SIM_TICK_MS != 0) {continue;}
+
+        // The simulated driver holds intake, lets go when the machine gives up, and clears hard jams by hand
+        if (now >= driver_back) {command = 12000;}
+        double reported_temperature = std::floor(temperature / 5.0) * 5.0;  // The motor reports in 5C steps
+        voltage = intake_update(machine, now, command, current + noise(rng) * 50.0, measured_speed + noise(rng) * 5.0,
+                                reported_temperature);
+
+        // Stopping when a hot motor really stalls on a block is right, stopping while it's turning isn't
+        if (machine.stats.jams != last_jams) {
+            last_jams = machine.stats.jams;
+            if (jam.active) {}
+            else if (now - turning >= machine.settings.stall_time) {block_stalls++;}
+            else {false_jams++;}
+        }
+        if (machine.locked && command > 0) {
+            if (!jam.active) {}
+            else if (jam.hard) {locked++;}
+            else {missed++;}  // Gave up on one reversing would have cleared
+            jam.active = false;
+            command = 0;
+            driver_back = now + 500;
+        }
+        if (jam.active && jam.hard && now - jam.start > SIM_CLEAR_BY + 2000) {
+            jam.active = false;
+            missed++;
+        }
+    }
+
+    double mean = cleared > 0 ? (double)clear_total / cleared : 0.0;
+    printf("%i s from %.0fC, a jam every %.1f s, %.0f%% hard, %i squeezes\n", options.seconds, options.temperature, options.jam_every,
+           options.hard_jams * 100.0, squeezes);
+    printf("%i jams: %i cleared, %i hard given up on of %i, %i missed, %i false jams, %i stalls on blocks\n", jams, cleared, locked, hard,
+           missed, false_jams, block_stalls);
+    printf("jam to clear %.0fms avg, %ums worst, ended at %.0fC\n", mean, clear_worst, temperature);
+    return missed > 0 || false_jams > 0 ? 1 : 0;
+}
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "../include/motion_profile.hpp"
+
+// ** @file profile_sim.cpp
+// ** @brief Compares EZ-Template's drive PID with the motion profiled drive on a simulated drive.
+// ** @details This isn't part of the robot build. Compile it on its own:
+//   g++ -std=c++17 -O2 -o profile_sim tools/profile_sim.cpp
+// Usage:
+//   profile_sim [--vel in/s] [--accel in/s^2] [--jerk in/s^3] [--kp n]
+// The drive has the free speed of a 450rpm 3.25" drive and a 2.5A a motor current limit. The PID drive is
+// default_constants() with DRIVE_SPEED and EZ-Template's slew. The profiled drive follows motion_profile.hpp with
+// feedforward and kP, then hands the last bit to the same PID like profile_drive.cpp does. Both have to hold EZ's
+// small exit, 1" for 90ms. Returns 1 if the profiled drives took longer in total.
+// ** @author Ansh Rao - 2145Z
+
+// Defining simulation constants
+#define SIM_TICK 0.01           // s, EZ-Template's PID and the executive run every 10ms
+#define SIM_STEP 0.001          // s, physics step
+#define SIM_FREE_SPEED 76.6     // in/s at 12V
+#define SIM_TIME_CONSTANT 0.25  // s for the drive to reach speed
+#define SIM_STALL_CURRENT 24.0  // A all six motors pull stalled at 12V, before the current limit
+#define SIM_CURRENT_LIMIT 15.0  // A, 2.5A a motor
+#define SIM_FRICTION 1.5        // A to keep the drive rolling
+#define SIM_KP 20.0             // default_constants() drive PID
+#define SIM_KD 100.0
+#define SIM_SPEED 110.0         // DRIVE_SPEED
+#define SIM_SLEW_DISTANCE 3.0   // in, slew_drive_constants_set(3_in, 70)
+#define SIM_SLEW_MIN 70.0
+#define SIM_SETTLE_SPEED 60.0   // profile_k.settle_speed
+#define SIM_SETTLE_ERROR 1.0    // in, EZ-Template's small exit
+#define SIM_SETTLE_TIME 0.09    // s
+#define SIM_TIMEOUT 4.0         // s
+
+// declaring sim options struct
+struct sim_options {
+    double vel = 60.0;
+    double accel = 150.0;
+    double jerk = 3000.0;
+    double kp = 15.0;
+};
+
+// @brief Parses command line options
+// @return False if an option wasn't recognised
+static bool sim_options_parse(int argc, char** argv, sim_options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--vel" && has_value) {options.vel = atof(argv[++i]);}
+        else if (arg == "--accel" && has_value) {options.accel = atof(argv[++i]);}
+        else if (arg == "--jerk" && has_value) {options.jerk = atof(argv[++i]);}
+        else if (arg == "--kp" && has_value) {options.kp = atof(argv[++i]);}
+        else {return false;}
+    }
+    return true;
+}
+
+// declaring sim drive struct
+struct sim_drive {
+    double position = 0.0;  // in
+    double velocity = 0.0;  // in/s
+
+    // @brief Moves the drive one physics step with a drive_set output
+    void step(double output) {
+        double wanted = SIM_STALL_CURRENT * (output / 127.0 - velocity / SIM_FREE_SPEED);
+        double current = std::clamp(wanted, -SIM_CURRENT_LIMIT, SIM_CURRENT_LIMIT);
+        double friction = velocity > 0.0 ? SIM_FRICTION : velocity < 0.0 ? -SIM_FRICTION : 0.0;
+        velocity += (current - friction) * SIM_FREE_SPEED / (SIM_STALL_CURRENT * SIM_TIME_CONSTANT) * SIM_STEP;
+        position += velocity * SIM_STEP;
+    }
+};
+
+// The feedforward a characterised drive would have, from the model above
+static const double sim_kS = SIM_FRICTION / SIM_STALL_CURRENT * 127.0;
+static const double sim_kV = 127.0 / SIM_FREE_SPEED;
+static const double sim_kA = 127.0 * SIM_TIME_CONSTANT / SIM_FREE_SPEED;
+
+// declaring sim pid struct
+// - EZ-Template's drive PID with slew, from a start position
+struct sim_pid {
+    double start, target, error_last;
+    double speed;
+    bool slew;
+
+    sim_pid(double start, double target, double speed, bool slew) : start(start), target(target), error_last(target - start), speed(speed), slew(slew) {}
+
+    double output(double position) {
+        double error = target - position;
+        double max = speed;
+        double traveled = std::fabs(position - start);
+        if (slew && traveled < SIM_SLEW_DISTANCE) {max = SIM_SLEW_MIN + (speed - SIM_SLEW_MIN) * traveled / SIM_SLEW_DISTANCE;}
+        double out = std::clamp(SIM_KP * error + SIM_KD * (error - error_last), -max, max);
+        error_last = error;
+        return out;
+    }
+};
+
+// @brief Drives a distance with EZ-Template's PID
+// @return Seconds until it settled
+static double sim_pid_drive(double distance) {
+    sim_drive drive;
+    sim_pid pid(0.0, distance, SIM_SPEED, true);
+    double output = 0.0, settled_for = 0.0;
+    for (int tick = 0; tick * SIM_TICK < SIM_TIMEOUT; tick++) {
+        output = pid.output(drive.position);
+        settled_for = std::fabs(distance - drive.position) < SIM_SETTLE_ERROR ? settled_for + SIM_TICK : 0.0;
+        if (settled_for >= SIM_SETTLE_TIME) {return tick * SIM_TICK;}
+        for (int i = 0; i < SIM_TICK / SIM_STEP; i++) {drive.step(output);}
+    }
+    return SIM_TIMEOUT;
+}
+
+// @brief Drives a distance with the motion profile, then the PID for the last bit
+// @return Seconds until it settled
+static double sim_profile_drive(double distance, const sim_options& options, double& worst_lag) {
+    sim_drive drive;
+    motion_profile profile = profile_make(distance, options.vel, options.accel, options.jerk);
+    double duration = profile_duration(profile);
+    sim_pid settle(0.0, 0.0, 0.0, false);
+    bool settling = false;
+    double output = 0.0, settled_for = 0.0;
+    for (int tick = 0; tick * SIM_TICK < SIM_TIMEOUT; tick++) {
+        double t = tick * SIM_TICK;
+        if (!settling && t >= duration) {
+            settle = sim_pid(drive.position, distance, SIM_SETTLE_SPEED, false);
+            settling = true;
+        }
+        if (!settling) {
+            profile_sample ref = profile_at(profile, t);
+            double sign = ref.vel > 0.0 ? 1.0 : ref.vel < 0.0 ? -1.0 : 0.0;
+            worst_lag = std::max(worst_lag, std::fabs(ref.pos - drive.position));
+            output = sim_kS * sign + sim_kV * ref.vel + sim_kA * ref.acc + options.kp * (ref.pos - drive.position);
+            output = std::clamp(output, -127.0, 127.0);
+        } else {
+            output = settle.output(drive.position);
+        }
+        settled_for = std::fabs(distance - drive.position) < SIM_SETTLE_ERROR ? settled_for + SIM_TICK : 0.0;
+        if (settled_for >= SIM_SETTLE_TIME) {return t;}
+        for (int i = 0; i < SIM_TICK / SIM_STEP; i++) {drive.step(output);}
+    }
+    return SIM_TIMEOUT;
+}
+
+int main(int argc, char** argv) {
+    sim_options options;
+    if (!sim_options_parse(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--vel in/s] [--accel in/s^2] [--jerk in/s^3] [--kp n]\n", argv[0]);
+        return 2;
+    }
+
+    const double distances[] = {6.0, 12.0, 24.0, 36.0, 48.0, -24.0};
+    double total_pid = 0.0, total_profile = 0.0;
+    printf("profile %.0f in/s, %.0f in/s^2, %.0f in/s^3, kP %.1f\n", options.vel, options.accel, options.jerk, options.kp);
+    printf("distance   pid      profile   saved   worst lag\n");
+    for (double distance : distances) {
+        double lag = 0.0;
+        double pid = sim_pid_drive(distance);
+        double profile = sim_profile_drive(distance, options, lag);
+        printf("%6.0fin   %5.0fms   %5.0fms   %+4.0fms   %.2fin\n", distance, pid * 1000.0, profile * 1000.0, (pid - profile) * 1000.0, lag);
+        total_pid += pid;
+        total_profile += profile;
+    }
+    printf("total %.0fms pid, %.0fms profile\n", total_pid * 1000.0, total_profile * 1000.0);
+    return total_profile > total_pid ? 1 : 0;
+}
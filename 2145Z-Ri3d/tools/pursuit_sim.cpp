@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../include/pursuit.hpp"
+
+// ** @file pursuit_sim.cpp
+// ** @brief Follows a long pure pursuit path on a simulated drive with full scans and a fixed lookahead, with
+// pursuit.hpp's windowed searches and adaptive lookahead, and with those and path_plan()'s speeds.
+// ** @details This isn't part of the robot build. Compile it on its own:
+//   g++ -std=c++17 -O2 -o pursuit_sim tools/pursuit_sim.cpp
+// Usage:
+//   pursuit_sim [--lanes n] [--speed n] [--look in]
+// The path snakes up and down --lanes 48" lanes 24" apart, injected at 0.5" and smoothed with EZ-Template's default
+// constants like path_cache.cpp does. Every follower drives it the way pursuit_drive.cpp does with the same
+// acceleration limits and feedforward and perfect odometry, but the robot slides if it turns harder than SIM_GRIP.
+// The fixed one scans the whole path for the closest and lookahead points every tick like EZ-Template's pure
+// pursuit, with a --look lookahead. It and the windowed one go the waypoints' --speed and only slow for the end, the
+// planned one slows for corners too. The last row is the windowed one with the waypoint speed turned down by hand
+// until it tracks as well as the planned one.
+// Returns 1 if the windowed follower checked more points a tick or tracked the path more than 10% worse, or if the
+// planned one tracked more than 10% worse than it or was more than 5% slower than the hand tuned speed.
+// ** @author Ansh Rao - 2145Z
+
+// Defining simulation constants
+#define SIM_TICK 0.01           // s, the follower runs every 10ms
+#define SIM_STEP 0.001          // s, physics step
+#define SIM_FREE_SPEED 76.6     // in/s at 12V
+#define SIM_TIME_CONSTANT 0.25  // s for the drive to reach speed
+#define SIM_STALL_CURRENT 12.0  // A one side's three motors pull stalled at 12V, before the current limit
+#define SIM_CURRENT_LIMIT 7.5   // A, 2.5A a motor
+#define SIM_FRICTION 0.75       // A to keep a side rolling
+#define SIM_TURN_RADIUS 7.0     // in, what trajectory_turn_radius() measures with scrub
+#define SIM_GRIP 200.0          // in/s^2 sideways the wheels hold before the robot slides
+#define SIM_LANE 48.0           // in
+#define SIM_LANE_GAP 24.0       // in
+#define SIM_SPACING 0.5         // in, odom_path_spacing_get()
+#define SIM_WEIGHT_SMOOTH 0.75  // odom_path_smooth_constants_get()
+#define SIM_WEIGHT_DATA 0.03
+#define SIM_TOLERANCE 0.0001
+#define SIM_TIMEOUT 60.0        // s
+#define SIM_SLOWEST 20.0        // drive_set, the slowest waypoint speed tried by hand
+
+// declaring sim options struct
+struct sim_options {
+    int lanes = 8;
+    double speed = 110.0;  // drive_set, DRIVE_SPEED
+    double look = 7.0;     // in, odom_look_ahead_get()
+};
+
+// @brief Parses command line options
+// @return False if an option wasn't recognised
+static bool sim_options_parse(int argc, char** argv, sim_options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--lanes" && has_value) {options.lanes = std::max(1, atoi(argv[++i]));}
+        else if (arg == "--speed" && has_value) {options.speed = atof(argv[++i]);}
+        else if (arg == "--look" && has_value) {options.look = atof(argv[++i]);}
+        else {return false;}
+    }
+    return true;
+}
+
+// The feedforward a characterised drive would have, from the model below
+static const double sim_kS = SIM_FRICTION / SIM_STALL_CURRENT * 127.0;
+static const double sim_kV = 127.0 / SIM_FREE_SPEED;
+static const double sim_kA = 127.0 * SIM_TIME_CONSTANT / SIM_FREE_SPEED;
+
+// pursuit_k
+static const pursuit_constants sim_k = {7.0, 12.0, 0.02, 0.7, 150.0, 150.0, 150.0, 4.0, 60};
+
+// @brief Builds the path like path_cache.cpp, injected, smoothed, measured and planned
+// @param planned False to only slow down for the end, like following the waypoint speeds without path_plan()
+static std::vector<path_point> sim_path(const sim_options& options, bool planned) {
+    std::vector<path_point> waypoints;
+    for (int lane = 0; lane < options.lanes; lane++) {
+        double x = lane * SIM_LANE_GAP;
+        waypoints.push_back({x, lane % 2 == 0 ? SIM_LANE : 0.0});
+        if (lane + 1 < options.lanes) {waypoints.push_back({x + SIM_LANE_GAP, lane % 2 == 0 ? SIM_LANE : 0.0});}
+    }
+
+    // path_inject()
+    std::vector<path_point> injected;
+    double from_x = 0.0, from_y = 0.0;
+    for (const path_point& waypoint : waypoints) {
+        double distance = std::hypot(waypoint.x - from_x, waypoint.y - from_y);
+        int count = distance / SIM_SPACING;
+        for (int i = 0; i < count; i++) {
+            double t = i * SIM_SPACING / distance;
+            injected.push_back({from_x + (waypoint.x - from_x) * t, from_y + (waypoint.y - from_y) * t});
+        }
+        from_x = waypoint.x;
+        from_y = waypoint.y;
+    }
+    injected.push_back(waypoints.back());
+
+    // path_smooth()
+    std::vector<path_point> path = injected;
+    double change = SIM_TOLERANCE;
+    while (change >= SIM_TOLERANCE) {
+        change = 0.0;
+        for (size_t i = 1; i + 1 < path.size(); i++) {
+            double before_x = path[i].x, before_y = path[i].y;
+            path[i].x += SIM_WEIGHT_DATA * (injected[i].x - path[i].x) + SIM_WEIGHT_SMOOTH * (path[i - 1].x + path[i + 1].x - 2.0 * path[i].x);
+            path[i].y += SIM_WEIGHT_DATA * (injected[i].y - path[i].y) + SIM_WEIGHT_SMOOTH * (path[i - 1].y + path[i + 1].y - 2.0 * path[i].y);
+            change += std::fabs(before_x - path[i].x) + std::fabs(before_y - path[i].y);
+        }
+    }
+
+    for (path_point& point : path) {point.speed = (options.speed - sim_kS) / sim_kV;}
+    path_measure(path);
+    pursuit_constants k = sim_k;
+    if (!planned) {k.max_lateral = INFINITY;}
+    path_plan(path, k);
+    return path;
+}
+
+// declaring sim side struct
+struct sim_side {
+    double velocity = 0.0;  // in/s
+
+    // @brief Moves the side one physics step with a drive_set output
+    void step(double output) {
+        double wanted = SIM_STALL_CURRENT * (output / 127.0 - velocity / SIM_FREE_SPEED);
+        double current = std::clamp(wanted, -SIM_CURRENT_LIMIT, SIM_CURRENT_LIMIT);
+        double friction = velocity > 0.0 ? SIM_FRICTION : velocity < 0.0 ? -SIM_FRICTION : 0.0;
+        velocity += (current - friction) * SIM_FREE_SPEED / (SIM_STALL_CURRENT * SIM_TIME_CONSTANT) * SIM_STEP;
+    }
+};
+
+// @brief trajectory_feedforward() for one side
+static double sim_feedforward(double vel, double accel) {
+    double output = sim_kV * vel + sim_kA * accel;
+    if (std::fabs(vel) > 0.1) {output += sim_kS * (vel > 0.0 ? 1.0 : -1.0);}
+    return std::clamp(output, -127.0, 127.0);
+}
+
+// @brief The fixed follower's searches, every point every tick
+static void sim_full_scan(const std::vector<path_point>& path, pursuit_state& state, double x, double y, double look, double& tx, double& ty) {
+    double best_distance = INFINITY;
+    for (size_t i = 0; i < path.size(); i++) {
+        double distance = std::hypot(path[i].x - x, path[i].y - y);
+        if (distance < best_distance) {
+            best_distance = distance;
+            state.closest = i;
+        }
+    }
+    state.checked = path.size();
+    state.target = 0;  // Searched again from the closest point every tick
+    pursuit_target(path, state, x, y, look, tx, ty);
+    state.checked = path.size() * 2;
+}
+
+// declaring sim result struct
+struct sim_result {
+    double time = SIM_TIMEOUT;  // s until EZ-Template would take over
+    double rms = 0.0;           // in off the path
+    double worst = 0.0;         // in
+    double checked = 0.0;       // points a tick, on average
+    int checked_worst = 0;
+};
+
+// @brief Follows the path
+// @param windowed True for pursuit.hpp's searches and adaptive lookahead, false for full scans and a fixed lookahead
+static sim_result sim_follow(const std::vector<path_point>& path, const sim_options& options, bool windowed) {
+    sim_side left, right;
+    pursuit_state state;
+    double x = 0.0, y = 0.0, theta = 0.0, vel = 0.0;
+    double course = 0.0;  // deg, the way the robot is really moving, behind theta while it slides
+    double sum_squared = 0.0, sum_checked = 0.0;
+    sim_result result;
+    int ticks = 0;
+    for (; ticks * SIM_TICK < SIM_TIMEOUT; ticks++) {
+        // The same as pursuit_iterate()
+        state.checked = 0;
+        if (windowed) {pursuit_closest(path, state, x, y);}
+        else {
+            double unused_x, unused_y;
+            sim_full_scan(path, state, x, y, options.look, unused_x, unused_y);
+        }
+        const path_point& here = path[state.closest];
+        const path_point& end = path.back();
+        if (state.closest + 1 >= path.size() || std::hypot(end.x - x, end.y - y) < sim_k.handoff) {
+            result.time = ticks * SIM_TICK;
+            break;
+        }
+
+        double tx, ty;
+        if (windowed) {pursuit_target(path, state, x, y, pursuit_lookahead(sim_k, vel, here.ahead), tx, ty);}
+        else {sim_full_scan(path, state, x, y, options.look, tx, ty);}
+        double curvature = pursuit_curvature(x, y, theta, tx, ty, false);
+
+        double target = std::min(here.vel, pursuit_speed_limit(curvature, (127.0 - sim_kS) / sim_kV, SIM_TURN_RADIUS));
+        double accel = std::clamp(target - vel, -sim_k.max_decel * SIM_TICK, sim_k.max_accel * SIM_TICK) / SIM_TICK;
+        vel += accel * SIM_TICK;
+        double turn = vel * curvature * SIM_TURN_RADIUS;
+        double left_output = sim_feedforward(vel + turn, accel);
+        double right_output = sim_feedforward(vel - turn, accel);
+
+        // How far off the path, measured properly
+        double off = INFINITY;
+        for (const path_point& point : path) {off = std::min(off, std::hypot(point.x - x, point.y - y));}
+        sum_squared += off * off;
+        result.worst = std::max(result.worst, off);
+        sum_checked += state.checked;
+        result.checked_worst = std::max(result.checked_worst, state.checked);
+
+        for (int step = 0; step < SIM_TICK / SIM_STEP; step++) {
+            left.step(left_output);
+            right.step(right_output);
+            double v = (left.velocity + right.velocity) / 2.0;
+            double w = (left.velocity - right.velocity) / (2.0 * SIM_TURN_RADIUS);
+            theta += w * 180.0 / M_PI * SIM_STEP;
+
+            // The wheels can only pull the robot's motion round as fast as SIM_GRIP lets them
+            double most = std::fabs(v) > 0.1 ? SIM_GRIP / std::fabs(v) * 180.0 / M_PI * SIM_STEP : 360.0;
+            course += std::clamp(std::remainder(theta - course, 360.0), -most, most);
+            double h = course * M_PI / 180.0;
+            x += v * std::sin(h) * SIM_STEP;
+            y += v * std::cos(h) * SIM_STEP;
+        }
+    }
+    result.rms = std::sqrt(sum_squared / std::max(ticks, 1));
+    result.checked = sum_checked / std::max(ticks, 1);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    sim_options options;
+    if (!sim_options_parse(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--lanes n] [--speed n] [--look in]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<path_point> path = sim_path(options, false);
+    std::vector<path_point> planned_path = sim_path(options, true);
+    sim_result fixed = sim_follow(path, options, false);
+    sim_result windowed = sim_follow(path, options, true);
+    sim_result planned = sim_follow(planned_path, options, true);
+    printf("%i lanes, %zu points, %.0f\" long, speed %.0f\n", options.lanes, path.size(), path.back().s, options.speed);
+    printf("follower   time     rms      worst    checked a tick (worst)\n");
+    printf("fixed      %5.2fs   %5.2fin  %5.2fin  %7.1f (%i)\n", fixed.time, fixed.rms, fixed.worst, fixed.checked, fixed.checked_worst);
+    printf("windowed   %5.2fs   %5.2fin  %5.2fin  %7.1f (%i)\n", windowed.time, windowed.rms, windowed.worst, windowed.checked, windowed.checked_worst);
+    printf("planned    %5.2fs   %5.2fin  %5.2fin  %7.1f (%i)\n", planned.time, planned.rms, planned.worst, planned.checked, planned.checked_worst);
+
+    // What tuning the waypoint speeds down by hand until the unplanned follower tracks as well would get
+    sim_options slowed = options;
+    sim_result tuned = windowed;
+    while (tuned.rms > planned.rms * 1.1 && slowed.speed > SIM_SLOWEST) {
+        slowed.speed -= 5.0;
+        tuned = sim_follow(sim_path(slowed, false), slowed, true);
+    }
+    printf("speed %3.0f  %5.2fs   %5.2fin  %5.2fin  %7.1f (%i)\n", slowed.speed, tuned.time, tuned.rms, tuned.worst, tuned.checked, tuned.checked_worst);
+    if (windowed.checked_worst > fixed.checked_worst || windowed.rms > fixed.rms * 1.1) {return 1;}
+    return planned.rms > windowed.rms * 1.1 || planned.time > tuned.time * 1.05 ? 1 : 0;
+}
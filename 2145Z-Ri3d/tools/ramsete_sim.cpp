@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../include/motion_profile.hpp"
+#include "../include/ramsete.hpp"
+#include "../include/trajectory_table.hpp"
+
+// ** @file ramsete_sim.cpp
+// ** @brief Follows a trajectory on a simulated drive with the linear follower and with RAMSETE.
+// ** @details This isn't part of the robot build. Compile it on its own:
+//   g++ -std=c++17 -O2 -o ramsete_sim tools/ramsete_sim.cpp
+// Usage:
+//   ramsete_sim [--vel in/s] [--offset in] [--heading deg] [--mismatch fraction] [--b n] [--zeta n] [--reversed]
+// The trajectory drives 24", turns 90 degrees right and drives 24" more, on an S-curve profile from
+// motion_profile.hpp, or backwards with --reversed. Its curvature eases in and out to a 24" radius like a spline's,
+// so a real drive could follow it. The robot starts --offset inches to the left of it and --heading degrees off, and
+// its right side is --mismatch slower than the feedforward thinks. Both followers get the same feedforward and perfect
+// odometry, the linear one with traj_k's gains. Returns 1 if RAMSETE tracked worse than the linear follower.
+// ** @author Ansh Rao - 2145Z
+
+// Defining simulation constants
+#define SIM_TICK 0.01           // s, the follower runs every 10ms
+#define SIM_STEP 0.001          // s, physics step
+#define SIM_FREE_SPEED 76.6     // in/s at 12V
+#define SIM_TIME_CONSTANT 0.25  // s for the drive to reach speed
+#define SIM_STALL_CURRENT 12.0  // A one side's three motors pull stalled at 12V, before the current limit
+#define SIM_CURRENT_LIMIT 7.5   // A, 2.5A a motor
+#define SIM_FRICTION 0.75       // A to keep a side rolling
+#define SIM_TURN_RADIUS 7.0     // in, what trajectory_turn_radius() measures with scrub
+#define SIM_ARC_RADIUS 24.0     // in at the tightest
+#define SIM_STRAIGHT 24.0       // in before and after the arc
+#define SIM_K_ALONG 2.0         // traj_k
+#define SIM_K_CROSS 3.0
+#define SIM_K_THETA 2.0
+
+// declaring sim options struct
+struct sim_options {
+    double vel = 50.0;      // in/s
+    double offset = 3.0;    // in to the left of the trajectory at the start
+    double heading = 10.0;  // deg clockwise of the trajectory at the start
+    double mismatch = 0.1;  // fraction the right side is slower than the feedforward thinks
+    bool reversed = false;  // drive the trajectory backwards
+    double b = 0.006;       // ramsete_k
+    double zeta = 0.7;
+};
+
+// @brief Parses command line options
+// @return False if an option wasn't recognised
+static bool sim_options_parse(int argc, char** argv, sim_options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--vel" && has_value) {options.vel = atof(argv[++i]);}
+        else if (arg == "--offset" && has_value) {options.offset = atof(argv[++i]);}
+        else if (arg == "--heading" && has_value) {options.heading = atof(argv[++i]);}
+        else if (arg == "--mismatch" && has_value) {options.mismatch = atof(argv[++i]);}
+        else if (arg == "--b" && has_value) {options.b = atof(argv[++i]);}
+        else if (arg == "--zeta" && has_value) {options.zeta = atof(argv[++i]);}
+        else if (arg == "--reversed") {options.reversed = true;}
+        else {return false;}
+    }
+    return true;
+}
+
+// @brief Builds the trajectory, one point every SIM_TICK
+// @details Integrates the profile along the path in physics steps so the points are exactly what a robot following
+// it would do. Starts at (0, 0) facing +y. The turn's curvature is sin^2 shaped, which over pi * radius of path
+// turns exactly 90 degrees.
+static std::vector<traj_point> sim_trajectory(const sim_options& options) {
+    const double arc = SIM_ARC_RADIUS * M_PI;
+    const double sign = options.reversed ? -1.0 : 1.0;
+    motion_profile profile = profile_make(2.0 * SIM_STRAIGHT + arc, options.vel, 150.0, 3000.0);
+    std::vector<traj_point> points;
+    double x = 0.0, y = 0.0, theta = 0.0, s = 0.0;
+    int steps_per_tick = SIM_TICK / SIM_STEP;
+    for (int step = 0; step * SIM_STEP <= profile_duration(profile); step++) {
+        double t = step * SIM_STEP;
+        profile_sample ref = profile_at(profile, t);
+        double into_arc = (ref.pos - SIM_STRAIGHT) / arc;
+        double curvature = into_arc > 0.0 && into_arc < 1.0 ? std::pow(std::sin(M_PI * into_arc), 2.0) / SIM_ARC_RADIUS : 0.0;
+        if (step % steps_per_tick == 0) {
+            traj_point point;
+            point.time = t;
+            point.x = x;
+            point.y = y;
+            point.theta = theta;
+            point.vel = sign * ref.vel;
+            point.accel = sign * ref.acc;
+            point.omega = sign * ref.vel * curvature * 180.0 / M_PI;
+            points.push_back(point);
+        }
+        double ds = sign * (ref.pos - s);
+        s = ref.pos;
+        double heading = theta * M_PI / 180.0;
+        x += ds * std::sin(heading);
+        y += ds * std::cos(heading);
+        theta += ds * curvature * 180.0 / M_PI;
+    }
+    return points;
+}
+
+// declaring sim side struct
+struct sim_side {
+    double velocity = 0.0;  // in/s
+
+    // @brief Moves the side one physics step with a drive_set output
+    // @param weak Fraction of the output the side really gets
+    void step(double output, double weak) {
+        double wanted = SIM_STALL_CURRENT * (output * (1.0 - weak) / 127.0 - velocity / SIM_FREE_SPEED);
+        double current = std::clamp(wanted, -SIM_CURRENT_LIMIT, SIM_CURRENT_LIMIT);
+        double friction = velocity > 0.0 ? SIM_FRICTION : velocity < 0.0 ? -SIM_FRICTION : 0.0;
+        velocity += (current - friction) * SIM_FREE_SPEED / (SIM_STALL_CURRENT * SIM_TIME_CONSTANT) * SIM_STEP;
+    }
+};
+
+// The feedforward a characterised drive would have, from the model above
+static const double sim_kS = SIM_FRICTION / SIM_STALL_CURRENT * 127.0;
+static const double sim_kV = 127.0 / SIM_FREE_SPEED;
+static const double sim_kA = 127.0 * SIM_TIME_CONSTANT / SIM_FREE_SPEED;
+static const double sim_kA_angular = sim_kA * SIM_TURN_RADIUS * M_PI / 180.0;  // per deg/s^2
+
+// @brief trajectory_feedforward() for one side
+static double sim_feedforward(double vel, double accel) {
+    double output = sim_kV * vel + sim_kA * accel;
+    if (std::fabs(vel) > 0.1) {output += sim_kS * (vel > 0.0 ? 1.0 : -1.0);}
+    return output;
+}
+
+// declaring sim result struct
+struct sim_result {
+    double rms = 0.0;    // in from the reference, over the whole trajectory
+    double worst = 0.0;  // in
+    double end = 0.0;    // in from the last point when the trajectory ends
+};
+
+// @brief Follows the trajectory
+// @param use_ramsete True for RAMSETE, false for the linear follower
+static sim_result sim_follow(const std::vector<traj_point>& points, const sim_options& options, bool use_ramsete) {
+    sim_side left, right;
+    double x = -options.offset, y = 0.0, theta = options.heading;
+    double sum_squared = 0.0;
+    sim_result result;
+    for (size_t i = 0; i < points.size(); i++) {
+        const traj_point& ref = points[i];
+        double alpha = i + 1 < points.size() ? (points[i + 1].omega - ref.omega) / SIM_TICK : 0.0;
+
+        // Error in the robot's frame, the same as trajectory_iterate()
+        double heading = theta * M_PI / 180.0;
+        double dx = ref.x - x, dy = ref.y - y;
+        double error_along = dx * std::sin(heading) + dy * std::cos(heading);
+        double error_cross = dx * std::cos(heading) - dy * std::sin(heading);
+        double error_theta = std::remainder(ref.theta - theta, 360.0);
+        double distance = std::hypot(dx, dy);
+        sum_squared += distance * distance;
+        result.worst = std::max(result.worst, distance);
+
+        double vel, omega;
+        if (use_ramsete) {
+            ramsete_command command = ramsete({options.b, options.zeta}, ref.vel, ref.omega, error_along, error_cross, error_theta);
+            vel = command.vel;
+            omega = command.omega;
+        } else {
+            vel = ref.vel + SIM_K_ALONG * error_along;
+            omega = ref.omega + SIM_K_CROSS * error_cross * (ref.vel >= 0 ? 1.0 : -1.0) + SIM_K_THETA * error_theta;
+        }
+        double turn = omega * M_PI / 180.0 * SIM_TURN_RADIUS;
+        double left_output = std::clamp(sim_feedforward(vel + turn, ref.accel) + sim_kA_angular * alpha, -127.0, 127.0);
+        double right_output = std::clamp(sim_feedforward(vel - turn, ref.accel) - sim_kA_angular * alpha, -127.0, 127.0);
+
+        for (int step = 0; step < SIM_TICK / SIM_STEP; step++) {
+            left.step(left_output, 0.0);
+            right.step(right_output, options.mismatch);
+            double v = (left.velocity + right.velocity) / 2.0;
+            double w = (left.velocity - right.velocity) / (2.0 * SIM_TURN_RADIUS);
+            double h = theta * M_PI / 180.0;
+            x += v * std::sin(h) * SIM_STEP;
+            y += v * std::cos(h) * SIM_STEP;
+            theta += w * 180.0 / M_PI * SIM_STEP;
+        }
+    }
+    result.rms = std::sqrt(sum_squared / points.size());
+    result.end = std::hypot(points.back().x - x, points.back().y - y);
+    return result;
+}
+
+int main(int argc, char** argv) {
+    sim_options options;
+    if (!sim_options_parse(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--vel in/s] [--offset in] [--heading deg] [--mismatch fraction] [--b n] [--zeta n] [--reversed]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<traj_point> points = sim_trajectory(options);
+    sim_result linear = sim_follow(points, options, false);
+    sim_result ram = sim_follow(points, options, true);
+    printf("%.0f in/s, starting %.1fin left and %.0f deg off, right side %.0f%% weak, %.2fs long\n", options.vel, options.offset,
+           options.heading, options.mismatch * 100.0, points.back().time);
+    printf("follower   rms      worst    end\n");
+    printf("linear    %5.2fin  %5.2fin  %5.2fin\n", linear.rms, linear.worst, linear.end);
+    printf("ramsete   %5.2fin  %5.2fin  %5.2fin\n", ram.rms, ram.worst, ram.end);
+    return ram.rms > linear.rms ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "../include/field_map.hpp"
+#include "../include/odom_math.hpp"
+#include "../include/pose_ekf.hpp"
+
+// ** @file reloc_sim.cpp
+// ** @brief Simulates a skills run to check the distance sensor wall correction before it goes on the robot.
+// ** @details This isn't part of the robot build. Compile it on its own:
+//   g++ -std=c++17 -O2 -o reloc_sim tools/reloc_sim.cpp
+// Usage:
+//   reloc_sim [--seconds s] [--seed n] [--slip fraction] [--outliers fraction] [--mount x,y,theta]
+// The robot drives laps around the field with drive encoders that under-read by --slip and a slowly drifting IMU.
+// The same EKF and field_map.hpp correction as the robot runs once without and once with the distance sensor, and
+// the position error of both is printed. --outliers is how often the sensor sees a field element instead of the wall.
+// ** @author Ansh Rao - 2145Z
+
+// Defining simulation constants
+#define SIM_PERIOD 0.005      // s, the same as ODOM_PERIOD
+#define SIM_RELOC_PERIOD 10   // odometry updates between sensor readings, the same as ODOM_RELOC_PERIOD
+#define SIM_SPEED 40.0        // in/s
+#define SIM_LAP_RADIUS 40.0   // inches from the center of the field
+
+// declaring sim options struct
+struct sim_options {
+    double seconds = 60.0;
+    unsigned seed = 1;
+    double slip = 0.02;
+    double outliers = 0.1;
+    sensor_mount mount = {0.0, 6.0, -90.0};  // pointing left, out towards the walls while driving laps clockwise
+};
+
+// @brief Parses command line options
+// @return False if an option wasn't recognised
+static bool sim_options_parse(int argc, char** argv, sim_options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--seconds" && has_value) {options.seconds = atof(argv[++i]);}
+        else if (arg == "--seed" && has_value) {options.seed = atoi(argv[++i]);}
+        else if (arg == "--slip" && has_value) {options.slip = atof(argv[++i]);}
+        else if (arg == "--outliers" && has_value) {options.outliers = atof(argv[++i]);}
+        else if (arg == "--mount" && has_value) {
+            sensor_mount& m = options.mount;
+            if (sscanf(argv[++i], "%lf,%lf,%lf", &m.x, &m.y, &m.theta) != 3) {return false;}
+        }
+        else {return false;}
+    }
+    return true;
+}
+
+// declaring sim result struct
+struct sim_result {
+    double rms = 0.0;
+    double worst = 0.0;
+    double final_error = 0.0;
+    double final_sigma = 0.0;
+    int used = 0;
+    int skipped = 0;
+    double correct_us = 0.0;  // mean time per correction
+};
+
+// @brief Runs one simulated skills run
+// @param options The simulation options
+// @param reloc True to correct with the distance sensor
+static sim_result sim_run(const sim_options& options, bool reloc) {
+    std::mt19937 rng(options.seed);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    // Start on the left of the lap facing forwards, the same as setting the pose at the start of skills
+    double x = -SIM_LAP_RADIUS, y = 0.0, theta = 0.0;
+    pose_ekf ekf;
+    ekf_reset(ekf, x, y, theta, 0.25, 0.25);
+    ekf_noise n;
+    reloc_settings settings;
+
+    double omega = SIM_SPEED / SIM_LAP_RADIUS * 180.0 / M_PI;  // deg/s to drive the lap
+    double imu_bias = 0.02;                                     // deg/s of drift
+    int steps = options.seconds / SIM_PERIOD;
+    sim_result result;
+    double sum_sq = 0.0, correct_total = 0.0;
+    for (int k = 0; k < steps; k++) {
+        // Truth
+        double d = SIM_SPEED * SIM_PERIOD;
+        double d_theta = omega * SIM_PERIOD;
+        double local_x, local_y;
+        odom_arc_local(d, 0.0, d_theta, 0.0, 0.0, local_x, local_y);
+        double mid = (theta + d_theta / 2.0) * M_PI / 180.0;
+        x += local_y * sin(mid) + local_x * cos(mid);
+        y += local_y * cos(mid) - local_x * sin(mid);
+        theta += d_theta;
+
+        // What the robot's sensors say
+        double d_ime = d * (1.0 - options.slip) + noise(rng) * 0.002;
+        double d_imu = d_theta + imu_bias * SIM_PERIOD + noise(rng) * 0.002;
+        odom_arc_local(d_ime, 0.0, d_imu, 0.0, 0.0, local_x, local_y);
+        double var_ime = n.ime_var * fabs(d_ime);
+        ekf_predict(ekf, local_x, local_y, d_imu, var_ime, var_ime, n.imu_var * fabs(d_imu) + n.imu_drift_var);
+
+        if (reloc && k % SIM_RELOC_PERIOD == 0) {
+            field_hit wall = reloc_expected(x, y, theta, options.mount, push_back_walls, std::size(push_back_walls));
+            if (wall.distance > 0.0 && wall.distance < 1500.0 / 25.4) {
+                double reading = wall.distance;
+                if (uniform(rng) < options.outliers) {reading *= uniform(rng);}  // Something in front of the wall
+                double sigma = std::max(15.0, reading * 25.4 * 0.05) / 25.4;
+                reading += noise(rng) * sigma;
+
+                auto start = std::chrono::steady_clock::now();
+                bool used = reloc_correct(ekf, options.mount, reading, sigma * sigma, push_back_walls, std::size(push_back_walls), settings);
+                correct_total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+                used ? result.used++ : result.skipped++;
+            }
+        }
+
+        double error = std::hypot(ekf.x - x, ekf.y - y);
+        sum_sq += error * error;
+        result.worst = std::max(result.worst, error);
+        result.final_error = error;
+    }
+    result.rms = std::sqrt(sum_sq / steps);
+    result.final_sigma = std::sqrt(ekf.P[0][0] + ekf.P[1][1]);
+    int corrections = result.used + result.skipped;
+    result.correct_us = corrections > 0 ? correct_total / corrections : 0.0;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    sim_options options;
+    if (!sim_options_parse(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--seconds s] [--seed n] [--slip fraction] [--outliers fraction] [--mount x,y,theta]\n", argv[0]);
+        return 2;
+    }
+
+    sim_result off = sim_run(options, false);
+    sim_result on = sim_run(options, true);
+    printf("%.0f s of laps, %.1f%% encoder slip, %.0f%% outliers\n", options.seconds, options.slip * 100.0, options.outliers * 100.0);
+    printf("%-16s %8s %8s %8s %8s\n", "", "rms", "max", "final", "sigma");
+    printf("%-16s %7.2f\" %7.2f\" %7.2f\" %7.2f\"\n", "odometry only", off.rms, off.worst, off.final_error, off.final_sigma);
+    printf("%-16s %7.2f\" %7.2f\" %7.2f\" %7.2f\"\n", "with walls", on.rms, on.worst, on.final_error, on.final_sigma);
+    printf("%i readings used, %i skipped, %.2f us per reading on this machine\n", on.used, on.skipped, on.correct_us);
+    return 0;
+}
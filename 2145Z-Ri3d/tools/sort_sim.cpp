@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../include/sort_pipeline.hpp"
+
+// ** @file sort_sim.cpp
+// ** @brief Runs the colour sort against a simulated belt to check it ejects the right blocks at the right time.
+// ** @details This isn't part of the robot build. Compile it on its own:
+//   g++ -std=c++17 -O2 -o sort_sim tools/sort_sim.cpp
+// Usage:
+//   sort_sim [--blocks n] [--seed n] [--speed deg/s] [--hue-noise deg] [--exit-error deg]
+// Blocks of random colours go up the belt with random gaps while the belt speeds up and slows down. The optical
+// sensor only updates every 3ms and its hue is noisy. A block is sorted right if the exit is ejecting when its
+// center passes the exit and it's the other colour, and wrong if the exit is ejecting for one of ours.
+// --exit-error moves the real exit away from where sort_settings thinks it is. Returns 1 if any block was sorted
+// wrong, so it can be run after changing the pipeline.
+// ** @author Ansh Rao - 2145Z
+
+// Defining simulation constants
+#define SIM_TICK_US 5000        // executive tick
+#define SIM_JITTER_US 300       // worst executive jitter
+#define SIM_OPTICAL_US 3000     // optical sensor integration time
+#define SIM_BLOCK_LENGTH 120.0  // roller degrees a block covers the sensor for
+
+// declaring sim options struct
+struct sim_options {
+    int blocks = 500;
+    unsigned seed = 1;
+    double speed = 900.0;      // roller deg/s
+    double hue_noise = 8.0;    // degrees
+    double exit_error = 0.0;   // degrees
+};
+
+// @brief Parses command line options
+// @return False if an option wasn't recognised
+static bool sim_options_parse(int argc, char** argv, sim_options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--blocks" && has_value) {options.blocks = atoi(argv[++i]);}
+        else if (arg == "--seed" && has_value) {options.seed = atoi(argv[++i]);}
+        else if (arg == "--speed" && has_value) {options.speed = atof(argv[++i]);}
+        else if (arg == "--hue-noise" && has_value) {options.hue_noise = atof(argv[++i]);}
+        else if (arg == "--exit-error" && has_value) {options.exit_error = atof(argv[++i]);}
+        else {return false;}
+    }
+    return true;
+}
+
+// declaring sim block struct
+struct sim_block {
+    double start;  // roller position the block reaches the sensor
+    block_color color;
+};
+
+int main(int argc, char** argv) {
+    sim_options options;
+    if (!sim_options_parse(argc, argv, options)) {
+        fprintf(stderr, "usage: %s [--blocks n] [--seed n] [--speed deg/s] [--hue-noise deg] [--exit-error deg]\n", argv[0]);
+        return 2;
+    }
+    std::mt19937 rng(options.seed);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    // Lay the blocks out on the belt, gaps are at least as long as an eject so one eject can't take two blocks
+    sort_pipeline pipeline;
+    pipeline.eject_color = BLOCK_BLUE;
+    std::vector<sim_block> blocks;
+    double at = 200.0;
+    for (int i = 0; i < options.blocks; i++) {
+        blocks.push_back({at, uniform(rng) < 0.5 ? BLOCK_RED : BLOCK_BLUE});
+        at += SIM_BLOCK_LENGTH + pipeline.settings.eject_length + uniform(rng) * 400.0;
+    }
+    double exit = pipeline.settings.sensor_to_exit + options.exit_error;
+    double end = at + exit + SIM_BLOCK_LENGTH;
+
+    uint64_t now = 0, optical_next = 0;
+    double position = 0.0, hue = 0.0, proximity = 0.0;
+    int right = 0, missed = 0, wrong = 0, passed = 0;
+    size_t next_judge = 0;
+    while (position < end) {
+        // The belt slows down and speeds up with load, and never runs backwards here
+        uint64_t dt = SIM_TICK_US + (uint64_t)(uniform(rng) * SIM_JITTER_US);
+        now += dt;
+        double speed = options.speed * (0.7 + 0.3 * std::sin(now / 1.0e6));
+        position += speed * dt / 1.0e6;
+
+        // The optical sensor holds its last reading between updates
+        if (now >= optical_next) {
+            optical_next = now + SIM_OPTICAL_US;
+            hue = 120.0;
+            proximity = 30.0 + noise(rng) * 5.0;
+            for (const sim_block& block : blocks) {
+                if (position < block.start || position > block.start + SIM_BLOCK_LENGTH) {continue;}
+                double center = block.color == BLOCK_RED ? pipeline.settings.red_hue : pipeline.settings.blue_hue;
+                hue = std::fmod(center + noise(rng) * options.hue_noise + 360.0, 360.0);
+                proximity = 220.0 + noise(rng) * 10.0;
+            }
+        }
+        bool ejecting = sort_update(pipeline, now, position, hue, proximity);
+
+        // Judge every block whose center passed the exit this tick
+        while (next_judge < blocks.size()) {
+            const sim_block& block = blocks[next_judge];
+            double center = block.start + SIM_BLOCK_LENGTH / 2.0 + exit;
+            if (center > position) {break;}
+            bool theirs = block.color == pipeline.eject_color;
+            if (theirs && ejecting) {right++;}
+            else if (theirs) {missed++;}
+            else if (ejecting) {wrong++;}
+            else {passed++;}
+            next_judge++;
+        }
+    }
+
+    const sort_stats& stats = pipeline.stats;
+    double mean = stats.ejected > 0 ? (double)stats.latency_total / stats.ejected / 1000.0 : 0.0;
+    printf("%i blocks at %.0f deg/s, %.0f deg hue noise, exit %+.0f deg from where the pipeline thinks\n", options.blocks, options.speed,
+           options.hue_noise, options.exit_error);
+    printf("detected %lu, dropped %lu\n", (unsigned long)stats.detected, (unsigned long)stats.dropped);
+    printf("theirs ejected %i, theirs missed %i, ours ejected %i, ours kept %i\n", right, missed, wrong, passed);
+    printf("detect to eject %.1fms avg, %.1fms worst, up to %.1f deg late\n", mean, stats.latency_worst / 1000.0, stats.late_worst);
+    return missed > 0 || wrong > 0 ? 1 : 0;
+}